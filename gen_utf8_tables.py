@@ -0,0 +1,81 @@
+import sys
+import unicodedata
+
+# Writes include/t4/internal/utf8_tables.h, the non-ASCII part of what t4_tokenize considers a word:
+#   python3 gen_utf8_tables.py > include/t4/internal/utf8_tables.h
+
+def is_word(c):
+    if 0xD800 <= c < 0xE000:
+        return False
+    category = unicodedata.category(chr(c))
+    # Marks too, so a decomposed "café" stays one word.
+    return category[0] == 'L' or category in ('Mn', 'Mc')
+
+def fold(c):
+    if 0xD800 <= c < 0xE000:
+        return c
+    ch = chr(c)
+    # Simple case folding: only single code point results, falling back to the simple lowercase mapping.
+    for mapped in (ch.casefold(), ch.lower()):
+        if len(mapped) == 1:
+            return ord(mapped)
+    return c
+
+def utf8_len(c):
+    return len(chr(c).encode('utf-8', 'surrogatepass'))
+
+words = []
+start = None
+for c in range(0x80, 0x110000):
+    if is_word(c) and start is None:
+        start = c
+    elif not is_word(c) and start is not None:
+        words.append((start, c - 1))
+        start = None
+if start is not None:
+    words.append((start, 0x10FFFF))
+
+# Folds that would change the encoded length are left out, so every word can be folded in place.
+def fold_in_place(c):
+    return fold(c) if utf8_len(fold(c)) == utf8_len(c) else c
+
+pairs = [(c, fold_in_place(c)) for c in range(0x80, 0x110000) if fold_in_place(c) != c]
+
+# Runs of code points the same distance apart which all move by the same delta, eg. the alternating
+# upper/lower pairs of Latin Extended-A.
+folds = []
+for c, f in pairs:
+    if folds:
+        first, last, delta, stride = folds[-1]
+        if f - c == delta and (c - last == stride or (first == last and c - last in (1, 2))):
+            folds[-1] = (first, c, delta, c - first if first == last else stride)
+            continue
+    folds.append((c, c, f - c, 1))
+
+# Every two byte character directly: its folding, with the top bit set if it is part of words.
+two_byte = [fold_in_place(c) | (0x8000 if is_word(c) else 0) for c in range(0x80, 0x800)]
+assert all(0x80 <= (v & 0x7fff) < 0x800 for v in two_byte)
+
+out = sys.stdout
+out.write('/* Generated by gen_utf8_tables.py from Unicode %s, do not edit. */\n\n' % unicodedata.unidata_version)
+out.write('#ifndef T4_INTERNAL_UTF8_TABLES_H_\n#define T4_INTERNAL_UTF8_TABLES_H_\n\n#include "t4/common.h"\n\n')
+out.write('typedef struct {\n    u32 first;\n    u32 last;\n} t4_utf8_range_t;\n\n')
+out.write('typedef struct {\n    u32 first;\n    u32 last;\n    i32 delta;\n    u32 stride;\n} t4_utf8_fold_t;\n\n')
+
+out.write('/* Non-ASCII code points that are part of words: letters and combining marks */\n')
+out.write('static const t4_utf8_range_t t4_utf8_word_ranges[%d] = {\n' % len(words))
+for first, last in words:
+    out.write('    { 0x%05X, 0x%05X },\n' % (first, last))
+out.write('};\n\n')
+
+out.write('/* U+0080 to U+07FF at [cp - 0x80]: the folded code point, | 0x8000 if it is part of words */\n')
+out.write('static const u16 t4_utf8_two_byte[%d] = {\n' % len(two_byte))
+for i in range(0, len(two_byte), 8):
+    out.write('    ' + ' '.join('0x%04X,' % v for v in two_byte[i:i + 8]) + '\n')
+out.write('};\n\n')
+
+out.write('/* Every stride-th code point from first to last folds to itself + delta */\n')
+out.write('static const t4_utf8_fold_t t4_utf8_folds[%d] = {\n' % len(folds))
+for first, last, delta, stride in folds:
+    out.write('    { 0x%05X, 0x%05X, %6d, %d },\n' % (first, last, delta, stride))
+out.write('};\n\n#endif /* T4_INTERNAL_UTF8_TABLES_H_ */\n')
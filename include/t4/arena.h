@@ -0,0 +1,34 @@
+#ifndef T4_ARENA_H_
+#define T4_ARENA_H_
+
+#include "t4/common.h"
+
+/* Size of a regular chunk, allocations bigger than a quarter of it get a chunk of their own. */
+#define T4_ARENA_CHUNK_SIZE (64 * 1024)
+
+typedef struct t4_arena_chunk t4_arena_chunk_t;
+
+/**
+ * Bump allocator for bytes which are only ever freed all at once. Consecutive allocations are laid out back to
+ * back within a chunk, so keys copied in one after another stay as close together as they were in their source.
+ */
+typedef struct t4_arena {
+    /* Newest first, the head is the one being bumped */
+    t4_arena_chunk_t * chunks;
+} t4_arena_t;
+
+static inline t4_arena_t t4_arena_new(void) {
+    return (t4_arena_t) { .chunks = NULL, };
+}
+
+/**
+ * @brief Copies size bytes of data into the arena.
+ *
+ * @return The copy, valid until @ref t4_arena_free
+ */
+extern void * t4_arena_copy(t4_arena_t * self, const void * data, size_t size);
+
+/* Frees every chunk, one free() each, no matter how many allocations were made. */
+extern void t4_arena_free(t4_arena_t * self);
+
+#endif /* T4_ARENA_H_ */
@@ -17,7 +17,10 @@ typedef int16_t i16;
 typedef int32_t i32;
 typedef int64_t i64;
 
-// TODO setup compiler specific defines, such as T4_INLINE to __attribute__((always_inline)) and such and T4_API
+// TODO setup compiler specific defines, such as T4_API
+
+/* For helpers that are only ever called with constant arguments, so every caller gets its own copy folded down. */
+#define T4_INLINE inline __attribute__((always_inline))
 
 #if defined(T4_DEBUG)
 
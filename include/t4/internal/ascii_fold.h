@@ -0,0 +1,173 @@
+#ifndef T4_ASCII_FOLD_H_
+#define T4_ASCII_FOLD_H_
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/wyhash.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
+/*
+ * ASCII case folding for the sets made with t4_stset_set_fold_case: 'A'..'Z' compare and hash like 'a'..'z', every
+ * other byte, non-ASCII ones included, stays as it is.
+ */
+
+static inline u8 t4_ascii_fold(const u8 c) {
+    return (u8)(c - 'A') < 26 ? c | 0x20 : c;
+}
+
+/* All 8 bytes of x at once: the top bit of each byte ends up set where 'A' <= byte <= 'Z', and is moved to 0x20. */
+static inline u64 t4_ascii_fold8(const u64 x) {
+    const u64 ones = 0x0101010101010101llu;
+
+    /* Without their top bit no byte can carry into the next one below. */
+    const u64 low = x & (0x7f * ones);
+    const u64 from_a = low + (0x80 - 'A') * ones;
+    const u64 past_z = low + (0x80 - 'Z' - 1) * ones;
+    const u64 upper = (from_a ^ past_z) & ~x & (0x80 * ones);
+
+    return x | (upper >> 2);
+}
+
+static inline bool t4_ascii_eq_folded(const void * a, const void * b, size_t n) {
+    const u8 * p = a;
+    const u8 * q = b;
+
+    for (; n >= 8; n -= 8, p += 8, q += 8) {
+        u64 x, y;
+        memcpy(&x, p, 8);
+        memcpy(&y, q, 8);
+        if (t4_ascii_fold8(x) != t4_ascii_fold8(y)) {
+            return false;
+        }
+    }
+
+    for (; n != 0; n--) {
+        if (t4_ascii_fold(*p++) != t4_ascii_fold(*q++)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Whether none of the n bytes at data has its top bit set, ie. there is nothing beyond ASCII to fold. */
+static inline bool t4_ascii_only(const void * data, size_t n) {
+    const u8 * p = data;
+    u64 any = 0;
+
+    for (; n >= 8; n -= 8, p += 8) {
+        u64 x;
+        memcpy(&x, p, 8);
+        any |= x;
+    }
+
+    for (; n != 0; n--) {
+        any |= *p++;
+    }
+
+    return (any & 0x8080808080808080llu) == 0;
+}
+
+#if defined(__SSE2__)
+
+/* Same as t4_ascii_fold8 for 16 bytes: 'a'..'z' with 0x20 set are biased to the 26 lowest signed bytes. */
+static inline __m128i t4_ascii_fold16(const __m128i x) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i biased = _mm_add_epi8(_mm_or_si128(x, case_bit), _mm_set1_epi8((char)(0x80 - 'a')));
+    const __m128i letters = _mm_cmpgt_epi8(_mm_set1_epi8((char)(0x80 + 26)), biased);
+
+    return _mm_or_si128(x, _mm_and_si128(letters, case_bit));
+}
+
+/* t4_key16_eq of the SIMD backends, folding both sides first; branching on a plain compare first is slower on text. */
+static inline bool t4_ascii_key16_eq_folded(const u8 * key, const void * data, const size_t n) {
+    if (T4_CROSSES_PAGE(data, 16)) {
+        return t4_ascii_eq_folded(key, data, n);
+    }
+
+    const __m128i x = t4_ascii_fold16(_mm_loadu_si128((const __m128i *)key));
+    const __m128i y = t4_ascii_fold16(_mm_loadu_si128((const __m128i *)data));
+    return (((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) | (0xffffu << n)) & 0xffffu) == 0xffffu;
+}
+
+#endif /* __SSE2__ */
+
+/*
+ * The hash only has to agree wherever the compare does, it need not fold exactly: setting 0x20 in every byte folds
+ * 'A'..'Z' in a single or per word read. It also merges a few pairs that are not letters, eg. '@' and '`', which
+ * the compare still tells apart; words only differing in those are rare enough that the extra H2 matches are cheap.
+ * A t4_phf cannot tell keys with the same hash apart at all, so it folds exactly, with t4_ascii_fold8.
+ */
+#define T4_ASCII_CASE_BITS 0x2020202020202020llu
+
+static inline u64 t4_wyr8_folded(const u8 * p, const bool exact) {
+    return exact ? t4_ascii_fold8(_wyr8(p)) : _wyr8(p) | T4_ASCII_CASE_BITS;
+}
+
+static inline u64 t4_wyr4_folded(const u8 * p, const bool exact) {
+    return exact ? t4_ascii_fold8(_wyr4(p)) : _wyr4(p) | (T4_ASCII_CASE_BITS >> 32);
+}
+
+static inline u64 t4_wyr3_folded(const u8 * p, const size_t k, const bool exact) {
+    return exact ? t4_ascii_fold8(_wyr3(p, k)) : _wyr3(p, k) | (T4_ASCII_CASE_BITS >> 40);
+}
+
+static T4_INLINE u64 t4_wyhash_folded_impl(const void * key, const size_t len, u64 seed, const u64 * secret, const bool exact) {
+    const u8 * p = key;
+    seed ^= _wymix(seed ^ secret[0], secret[1]);
+    u64 a, b;
+
+    if (_likely_(len <= 16)) {
+        if (_likely_(len >= 4)) {
+            a = (t4_wyr4_folded(p, exact) << 32) | t4_wyr4_folded(p + ((len >> 3) << 2), exact);
+            b = (t4_wyr4_folded(p + len - 4, exact) << 32) | t4_wyr4_folded(p + len - 4 - ((len >> 3) << 2), exact);
+        } else if (_likely_(len > 0)) {
+            a = t4_wyr3_folded(p, len, exact);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (_unlikely_(i >= 48)) {
+            u64 see1 = seed, see2 = seed;
+            do {
+                seed = _wymix(t4_wyr8_folded(p, exact) ^ secret[1], t4_wyr8_folded(p + 8, exact) ^ seed);
+                see1 = _wymix(t4_wyr8_folded(p + 16, exact) ^ secret[2], t4_wyr8_folded(p + 24, exact) ^ see1);
+                see2 = _wymix(t4_wyr8_folded(p + 32, exact) ^ secret[3], t4_wyr8_folded(p + 40, exact) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (_likely_(i >= 48));
+            seed ^= see1 ^ see2;
+        }
+        while (_unlikely_(i > 16)) {
+            seed = _wymix(t4_wyr8_folded(p, exact) ^ secret[1], t4_wyr8_folded(p + 8, exact) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = t4_wyr8_folded(p + i - 16, exact);
+        b = t4_wyr8_folded(p + i - 8, exact);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    _wymum(&a, &b);
+    return _wymix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+/* wyhash, reading every word through the above; keys that only differ in ASCII case get the same hash. */
+static inline u64 t4_wyhash_folded(const void * key, const size_t len, const u64 seed, const u64 * secret) {
+    return t4_wyhash_folded_impl(key, len, seed, secret, false);
+}
+
+/* Same as @ref t4_wyhash_folded, but only ASCII case is merged; keys differing in anything else hash apart. */
+static inline u64 t4_wyhash_folded_exact(const void * key, const size_t len, const u64 seed, const u64 * secret) {
+    return t4_wyhash_folded_impl(key, len, seed, secret, true);
+}
+
+#endif /* T4_ASCII_FOLD_H_ */
@@ -0,0 +1,52 @@
+#ifndef T4_STSET_GROUP_AVX2_H_
+#define T4_STSET_GROUP_AVX2_H_
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+typedef __m256i t4_group_avx2;
+
+enum { t4_group_width_avx2 = sizeof(__m256i) };
+
+static inline t4_group_avx2 t4_group_load_avx2(const u8 * metadata) {
+    return _mm256_load_si256((const __m256i *)metadata);
+}
+
+static inline u64 t4_group_match_avx2(const t4_group_avx2 group, const u8 h2) {
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(group, _mm256_set1_epi8((char)h2)));
+}
+
+static inline u64 t4_group_match_empty_avx2(const t4_group_avx2 group) {
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(group, _mm256_setzero_si256()));
+}
+
+/* movemask already collects the filled bit of every byte, so there is no need for an andnot with 0x80. */
+static inline u64 t4_group_match_free_avx2(const t4_group_avx2 group) {
+    return (u32)~_mm256_movemask_epi8(group);
+}
+
+static inline size_t t4_group_mask_first_avx2(const u64 mask) {
+    return (size_t)__builtin_ctzll(mask);
+}
+
+/* Keys are only 16 bytes, so this is the SSE compare, VEX encoded. */
+static inline bool t4_key16_eq_avx2(const u8 * key, const void * data, const size_t n) {
+    if (T4_CROSSES_PAGE(data, 16)) {
+        return memcmp(key, data, n) == 0;
+    }
+
+    /* Reads past the end of data, but never into the next page; those bytes are masked off. */
+    const __m128i x = _mm_loadu_si128((const __m128i *)key);
+    const __m128i y = _mm_loadu_si128((const __m128i *)data);
+    return (((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) | (0xffffu << n)) & 0xffffu) == 0xffffu;
+}
+
+static inline bool t4_key16_eq_folded_avx2(const u8 * key, const void * data, const size_t n) {
+    return t4_ascii_key16_eq_folded(key, data, n);
+}
+
+#endif /* T4_STSET_GROUP_AVX2_H_ */
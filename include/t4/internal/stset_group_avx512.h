@@ -0,0 +1,56 @@
+#ifndef T4_STSET_GROUP_AVX512_H_
+#define T4_STSET_GROUP_AVX512_H_
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+/**
+ * 64 slots per group, so one probe covers a whole cache line of metadata. Needs AVX-512BW for the byte
+ * compares into a __mmask64.
+ */
+
+typedef __m512i t4_group_avx512;
+
+enum { t4_group_width_avx512 = sizeof(__m512i) };
+
+static inline t4_group_avx512 t4_group_load_avx512(const u8 * metadata) {
+    return _mm512_load_si512((const void *)metadata);
+}
+
+static inline u64 t4_group_match_avx512(const t4_group_avx512 group, const u8 h2) {
+    return _mm512_cmpeq_epi8_mask(group, _mm512_set1_epi8((char)h2));
+}
+
+static inline u64 t4_group_match_empty_avx512(const t4_group_avx512 group) {
+    return _mm512_testn_epi8_mask(group, group);
+}
+
+static inline u64 t4_group_match_free_avx512(const t4_group_avx512 group) {
+    return ~_mm512_movepi8_mask(group);
+}
+
+static inline size_t t4_group_mask_first_avx512(const u64 mask) {
+    return (size_t)__builtin_ctzll(mask);
+}
+
+/* The 128-bit mask compares need AVX-512VL, which is not in the flags of this backend. */
+static inline bool t4_key16_eq_avx512(const u8 * key, const void * data, const size_t n) {
+    if (T4_CROSSES_PAGE(data, 16)) {
+        return memcmp(key, data, n) == 0;
+    }
+
+    /* Reads past the end of data, but never into the next page; those bytes are masked off. */
+    const __m128i x = _mm_loadu_si128((const __m128i *)key);
+    const __m128i y = _mm_loadu_si128((const __m128i *)data);
+    return (((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) | (0xffffu << n)) & 0xffffu) == 0xffffu;
+}
+
+static inline bool t4_key16_eq_folded_avx512(const u8 * key, const void * data, const size_t n) {
+    return t4_ascii_key16_eq_folded(key, data, n);
+}
+
+#endif /* T4_STSET_GROUP_AVX512_H_ */
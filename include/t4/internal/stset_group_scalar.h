@@ -0,0 +1,63 @@
+#ifndef T4_STSET_GROUP_SCALAR_H_
+#define T4_STSET_GROUP_SCALAR_H_
+
+#include "t4/common.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <string.h>
+
+/**
+ * Portable fallback, probes 8 metadata bytes at a time with plain 64-bit arithmetic (SWAR).
+ *
+ * Masks have the top bit of each matching byte set, so the slot index is the trailing zero count divided by 8.
+ * This assumes a little endian host, which is all we run on anyway.
+ */
+
+#define T4_SWAR_LSB 0x0101010101010101lu
+#define T4_SWAR_MSB 0x8080808080808080lu
+
+typedef u64 t4_group_scalar;
+
+enum { t4_group_width_scalar = sizeof(u64) };
+
+static inline t4_group_scalar t4_group_load_scalar(const u8 * metadata) {
+    u64 group;
+    memcpy(&group, metadata, sizeof(group));
+    return group;
+}
+
+/*
+ * Sets the top bit of every zero byte in x. The usual (x - lsb) & ~x & msb trick can report false positives
+ * above a real match because of the borrow; this one never carries across byte boundaries, so it is exact.
+ */
+static inline u64 t4_swar_zero_bytes(const u64 x) {
+    return ~(((x & ~T4_SWAR_MSB) + ~T4_SWAR_MSB) | x | ~T4_SWAR_MSB);
+}
+
+static inline u64 t4_group_match_scalar(const t4_group_scalar group, const u8 h2) {
+    return t4_swar_zero_bytes(group ^ (T4_SWAR_LSB * h2));
+}
+
+static inline u64 t4_group_match_empty_scalar(const t4_group_scalar group) {
+    return t4_swar_zero_bytes(group);
+}
+
+/* Free slots (empty or deleted) are the ones without the filled bit. */
+static inline u64 t4_group_match_free_scalar(const t4_group_scalar group) {
+    return ~group & T4_SWAR_MSB;
+}
+
+static inline size_t t4_group_mask_first_scalar(const u64 mask) {
+    return (size_t)__builtin_ctzll(mask) >> 3lu;
+}
+
+/* No vector compare to be had here, but the key is still in the entry, so this is no pointer chase. */
+static inline bool t4_key16_eq_scalar(const u8 * key, const void * data, const size_t n) {
+    return memcmp(key, data, n) == 0;
+}
+
+static inline bool t4_key16_eq_folded_scalar(const u8 * key, const void * data, const size_t n) {
+    return t4_ascii_eq_folded(key, data, n);
+}
+
+#endif /* T4_STSET_GROUP_SCALAR_H_ */
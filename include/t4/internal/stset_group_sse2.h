@@ -0,0 +1,54 @@
+#ifndef T4_STSET_GROUP_SSE2_H_
+#define T4_STSET_GROUP_SSE2_H_
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <emmintrin.h>
+#include <string.h>
+
+/**
+ * 16 slots per group, a quarter of a cache line. Only needs SSE2, so this runs on every x86_64 CPU.
+ */
+
+typedef __m128i t4_group_sse2;
+
+enum { t4_group_width_sse2 = sizeof(__m128i) };
+
+static inline t4_group_sse2 t4_group_load_sse2(const u8 * metadata) {
+    return _mm_load_si128((const __m128i *)metadata);
+}
+
+static inline u64 t4_group_match_sse2(const t4_group_sse2 group, const u8 h2) {
+    return (u16)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static inline u64 t4_group_match_empty_sse2(const t4_group_sse2 group) {
+    return (u16)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_setzero_si128()));
+}
+
+static inline u64 t4_group_match_free_sse2(const t4_group_sse2 group) {
+    return (u16)~_mm_movemask_epi8(group);
+}
+
+static inline size_t t4_group_mask_first_sse2(const u64 mask) {
+    return (size_t)__builtin_ctzll(mask);
+}
+
+static inline bool t4_key16_eq_sse2(const u8 * key, const void * data, const size_t n) {
+    if (T4_CROSSES_PAGE(data, 16)) {
+        return memcmp(key, data, n) == 0;
+    }
+
+    /* Reads past the end of data, but never into the next page; those bytes are masked off. */
+    const __m128i x = _mm_loadu_si128((const __m128i *)key);
+    const __m128i y = _mm_loadu_si128((const __m128i *)data);
+    return (((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) | (0xffffu << n)) & 0xffffu) == 0xffffu;
+}
+
+static inline bool t4_key16_eq_folded_sse2(const u8 * key, const void * data, const size_t n) {
+    return t4_ascii_key16_eq_folded(key, data, n);
+}
+
+#endif /* T4_STSET_GROUP_SSE2_H_ */
@@ -0,0 +1,39 @@
+#ifndef T4_STSET_HASH_H_
+#define T4_STSET_HASH_H_
+
+#ifndef T4_STSET_H_
+#   error "Do not include this file directly."
+#endif
+
+#include "t4/common.h"
+#include "t4/wyhash.h"
+#include "t4/internal/ascii_fold.h"
+
+/*
+ * Sets only keep the low 32 bits of a hash. H2 is the bottom 7 of them; the probe start is taken from the top bits
+ * of H1, which only reach down into H2 in sets of more than 2^25 groups.
+ */
+#define T4_GET_H1(hash) ((u32)(hash))
+#define T4_GET_H2(hash) ((u64)(hash) & 0x7flu)
+
+/* Shared by every set, set by t4_internal_stset_init() (or before main with static dispatch) */
+extern u64 t4_internal_stset_seed;
+
+/*
+ * Makes a H1|H2 hash for use within the set. wyhash is already well mixed in every bit, so H1 and H2 are taken
+ * from it as is, see T4_GET_H1 and T4_GET_H2.
+ */
+static inline u64 t4_make_hash_h1h2(const void * key, const size_t size) {
+    return wyhash(key, size, t4_internal_stset_seed, _wyp);
+}
+
+/* The hash of sets with fold_case, see t4_stset_set_fold_case. */
+static inline u64 t4_make_hash_h1h2_folded(const void * key, const size_t size) {
+    return t4_wyhash_folded(key, size, t4_internal_stset_seed, _wyp);
+}
+
+static T4_INLINE u64 t4_make_hash_h1h2_for(const void * key, const size_t size, const bool fold) {
+    return fold ? t4_make_hash_h1h2_folded(key, size) : t4_make_hash_h1h2(key, size);
+}
+
+#endif /* T4_STSET_HASH_H_ */
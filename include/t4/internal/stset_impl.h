@@ -0,0 +1,636 @@
+/**
+ * The probing logic of the set, written once against a "group" of metadata bytes.
+ *
+ * Every backend provides the same handful of group primitives, suffixed with its name:
+ *  - t4_group_<isa>:             the register type holding one group;
+ *  - t4_group_width_<isa>:       number of slots per group, also the metadata alignment;
+ *  - t4_group_load_<isa>:        aligned load of one group;
+ *  - t4_group_match_<isa>:       bitmask of slots whose metadata equals a H2 byte;
+ *  - t4_group_match_empty_<isa>: bitmask of empty slots (metadata 0), the ones that end a probe;
+ *  - t4_group_match_free_<isa>:  bitmask of empty or deleted slots, the ones an insert may take;
+ *  - t4_group_mask_first_<isa>:  slot index of the lowest bit of a non-zero mask;
+ *  - t4_key16_eq_<isa>:          whether an inline key equals the first 0 < n <= T4_STSET_INLINE bytes at a pointer;
+ *  - t4_key16_eq_folded_<isa>:   the same, ignoring ASCII case, for sets with fold_case.
+ *
+ * Define T4_STSET_BACKEND to that suffix and include this file, which then defines
+ * t4_stset_{get_alignment,new,free,insert_unchecked,try_insert,exists,...}_<isa>. Every backend lives in its own
+ * translation unit (src/stset_<isa>.c) built with only its own -m flags, see CMakeLists.txt. When a backend is
+ * pinned at compile time t4/stset.h includes this directly instead, so everything here is static inline.
+ */
+#ifndef T4_STSET_IMPL_H_
+#define T4_STSET_IMPL_H_
+
+#ifndef T4_STSET_H_
+#   error "Do not include this file directly."
+#endif
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/arena.h"
+#include "t4/internal/stset_hash.h"
+
+#include <string.h>
+
+/*
+ * Metadata of a slot: 0 if it was never used, the tombstone of a removed key, or H2 with the filled bit. A
+ * tombstone does not end a probe, since keys inserted while its slot was filled may live further along.
+ */
+#define T4_EMPTY ((u8)0x00)
+#define T4_DELETED ((u8)0x7f)
+#define T4_FILLED ((u8)0x80)
+
+/* Where a probe is, and how far its next step goes. */
+typedef struct t4_stset_probe {
+    size_t pos;
+    size_t stride;
+} t4_stset_probe_t;
+
+/* Number of keys hashed and prefetched ahead by the batch functions. */
+#define T4_STSET_BATCH 16
+
+#define T4_CONCAT_(a, b) a##_##b
+#define T4_CONCAT(a, b) T4_CONCAT_(a, b)
+
+/* eg. T4_STSET_FN(t4_group_load) -> t4_group_load_avx2 */
+#define T4_STSET_FN(name) T4_CONCAT(name, T4_STSET_BACKEND)
+
+static inline void t4_stset_free_impl(t4_stset_t * self) {
+    t4_free(self->entries);
+    t4_free(self->values);
+    t4_free(self->index);
+    t4_free_aligned(self->metadata);
+    t4_arena_free(&self->arena);
+    self->capacity = 0;
+    self->num_entries = 0;
+    self->entries_capacity = 0;
+    self->size = 0;
+    self->tombstones = 0;
+    self->growth_left = 0;
+}
+
+/* Smallest power of two >= n, n must be non-zero. */
+static inline size_t t4_stset_round_capacity(const size_t n) {
+    return n <= 1 ? 1 : (size_t)1 << (64 - __builtin_clzll(n - 1));
+}
+
+/* Appends the key to entries, with a zeroed value if this is a map, and points slot i at it; there must be room. */
+static inline void t4_stset_put(t4_stset_t * self, const size_t i, const u64 hash, void * data, const size_t data_size) {
+    t4_debug_assert(data_size < T4_STSET_REMOVED);
+
+    t4_stset_entry_t * e = self->entries + self->num_entries;
+
+    if (data_size <= T4_STSET_INLINE) {
+        memset(e->bytes, 0, T4_STSET_INLINE);
+        memcpy(e->bytes, data, data_size);
+    } else {
+        e->data = self->owns_keys ? t4_arena_copy(&self->arena, data, data_size) : data;
+    }
+
+    e->size = (u32)data_size;
+    e->hash = (u32)hash;
+
+    if (self->value_size != 0) {
+        memset(self->values + self->num_entries * self->value_size, 0, self->value_size);
+    }
+
+    self->metadata[i] = T4_GET_H2(hash) | T4_FILLED;
+    self->index[i] = (u32)self->num_entries++;
+}
+
+#endif /* T4_STSET_IMPL_H_ */
+
+#ifndef T4_STSET_BACKEND
+#   error "Define T4_STSET_BACKEND to the suffix of the group primitives before including this file."
+#endif
+
+/* This alignment is purely for the metadata. */
+static inline size_t T4_STSET_FN(t4_stset_get_alignment)(void) {
+    return T4_STSET_FN(t4_group_width);
+}
+
+static inline t4_stset_t T4_STSET_FN(t4_stset_new)(size_t capacity) {
+    const size_t width = T4_STSET_FN(t4_group_width);
+
+    const size_t hint = capacity < 1024 ? 1024 : capacity;
+
+    /* A power of two, so probes wrap around with a mask; every group width divides it too. */
+    capacity = t4_stset_round_capacity(hint);
+
+    const size_t max = t4_stset_max_used(capacity, T4_STSET_DEFAULT_MAX_LOAD_FACTOR);
+
+    /* Only the slots are rounded up, entries start out with room for as many keys as were asked for. */
+    const size_t entries_capacity = hint < max ? hint : max;
+
+    return (t4_stset_t) {
+        .capacity = capacity,
+        .metadata = t4_calloc_aligned(capacity, width),
+        // NOTE doesn't really need to be zeroed, consider switching to a malloc instead
+        .index = t4_calloc(capacity, sizeof(u32)),
+        .entries = t4_calloc(entries_capacity, sizeof(t4_stset_entry_t)),
+        .num_entries = 0,
+        .entries_capacity = entries_capacity,
+        .size = 0,
+        .tombstones = 0,
+        .growth_left = max,
+        .max_load_factor = T4_STSET_DEFAULT_MAX_LOAD_FACTOR,
+        .fold_case = false,
+        .owns_keys = false,
+        .arena = t4_arena_new(),
+        .key_base = NULL,
+        .value_size = 0,
+        .values = NULL,
+    };
+}
+
+/*
+ * Scales H1 to [0, capacity) by its top bits, so it works with the 32 bits of the hash entries keep; the capacity is
+ * a power of two and a multiple of the width, so clearing the low bits aligns the start down to a group.
+ */
+static inline t4_stset_probe_t T4_STSET_FN(t4_stset_probe_start)(const t4_stset_t * self, const u64 hash) {
+    return (t4_stset_probe_t) {
+        .pos = (size_t)(((u64)T4_GET_H1(hash) * self->capacity) >> 32) & ~(T4_STSET_FN(t4_group_width) - 1),
+        .stride = 0,
+    };
+}
+
+/*
+ * Moves on by one more group each step, so the k-th probe lands k(k+1)/2 groups after the start. Triangular numbers
+ * hit every residue modulo a power of two, so this still visits every group before coming back to the start.
+ * T4_STSET_LINEAR_PROBING goes back to one group per step, which is only kept around to compare probe lengths.
+ */
+static inline void T4_STSET_FN(t4_stset_probe_next)(const t4_stset_t * self, t4_stset_probe_t * probe) {
+#if defined(T4_STSET_LINEAR_PROBING)
+    probe->stride = T4_STSET_FN(t4_group_width);
+#else
+    probe->stride += T4_STSET_FN(t4_group_width);
+#endif
+    probe->pos = (probe->pos + probe->stride) & (self->capacity - 1);
+}
+
+static inline void T4_STSET_FN(t4_stset_free)(t4_stset_t * self) {
+    t4_stset_free_impl(self);
+}
+
+/*
+ * Longer keys of a set with fold_case, 16 bytes at a time with the inline compare; the last step overlaps the one
+ * before it instead of reading past the end of either key.
+ */
+static inline bool T4_STSET_FN(t4_stset_key_eq_folded)(const u8 * key, const u8 * data, const size_t n) {
+    for (size_t i = 0; i + T4_STSET_INLINE < n; i += T4_STSET_INLINE) {
+        if (!T4_STSET_FN(t4_key16_eq_folded)(key + i, data + i, T4_STSET_INLINE)) {
+            return false;
+        }
+    }
+
+    return T4_STSET_FN(t4_key16_eq_folded)(key + n - T4_STSET_INLINE, data + n - T4_STSET_INLINE, T4_STSET_INLINE);
+}
+
+/*
+ * Short keys are compared in the entry itself, without following a pointer or calling memcmp. fold is always a
+ * constant, the probes below are written once and copied for either value of fold_case, so a set that does not
+ * fold case never pays for the sets that do.
+ */
+static T4_INLINE bool T4_STSET_FN(t4_stset_entry_eq)(const t4_stset_t * self, const t4_stset_entry_t * e, const void * data, const size_t data_size, const bool fold) {
+    if (data_size != e->size) {
+        return false;
+    }
+
+    /* An empty key may point just past its buffer, so not even its first byte can be read. */
+    if (data_size <= T4_STSET_INLINE) {
+        return data_size == 0 || (fold ? T4_STSET_FN(t4_key16_eq_folded)(e->bytes, data, data_size)
+                                       : T4_STSET_FN(t4_key16_eq)(e->bytes, data, data_size));
+    }
+
+    const void * key = t4_stset_entry_data(self, e);
+
+    return fold ? T4_STSET_FN(t4_stset_key_eq_folded)(key, data, data_size)
+                : memcmp(data, key, data_size) == 0;
+}
+
+/*
+ * Returns the index of the first free slot along the probe sequence of hash. There always is one, growth_left
+ * keeps at least one slot of every set empty.
+ */
+static inline size_t T4_STSET_FN(t4_stset_find_free)(const t4_stset_t * self, const u64 hash) {
+    t4_stset_probe_t probe = T4_STSET_FN(t4_stset_probe_start)(self, hash);
+
+    for (;; T4_STSET_FN(t4_stset_probe_next)(self, &probe)) {
+        const size_t i = probe.pos;
+        const T4_STSET_FN(t4_group) group = T4_STSET_FN(t4_group_load)(self->metadata + i);
+        const u64 avail = T4_STSET_FN(t4_group_match_free)(group);
+
+        if (avail) {
+            return i + T4_STSET_FN(t4_group_mask_first)(avail);
+        }
+    }
+}
+
+/*
+ * Drops the removed keys from entries (and values, in a map), keeping the rest in order, and points a cleared index
+ * at them again. Every key is already unique and there is room for all of them, so no checks are needed. This is
+ * how tombstones are cleared in place, and the second half of growing.
+ */
+static inline void T4_STSET_FN(t4_stset_rebuild)(t4_stset_t * self) {
+    size_t n = 0;
+    for (size_t k = 0; k < self->num_entries; k++) {
+        if (self->entries[k].size == T4_STSET_REMOVED) {
+            continue;
+        }
+
+        if (self->value_size != 0) {
+            memmove(self->values + n * self->value_size, self->values + k * self->value_size, self->value_size);
+        }
+
+        self->entries[n++] = self->entries[k];
+    }
+
+    memset(self->metadata, T4_EMPTY, self->capacity);
+
+    for (size_t k = 0; k < n; k++) {
+        const u64 hash = self->entries[k].hash;
+        const size_t j = T4_STSET_FN(t4_stset_find_free)(self, hash);
+
+        self->metadata[j] = T4_GET_H2(hash) | T4_FILLED;
+        self->index[j] = (u32)k;
+    }
+
+    self->num_entries = n;
+    self->tombstones = 0;
+    self->growth_left = t4_stset_max_used(self->capacity, self->max_load_factor) - self->size;
+}
+
+/* At least doubles the slots, until they are enough for every key of self. Entries are left as they are. */
+static inline void T4_STSET_FN(t4_stset_increase_capacity)(t4_stset_t * self) {
+    const size_t width = T4_STSET_FN(t4_group_width);
+
+    size_t capacity = self->capacity * 2;
+    while (t4_stset_max_used(capacity, self->max_load_factor) <= self->size) {
+        capacity *= 2;
+    }
+
+    t4_free_aligned(self->metadata);
+    t4_free(self->index);
+
+    self->capacity = capacity;
+    self->metadata = t4_calloc_aligned(capacity, width);
+    self->index = t4_calloc(capacity, sizeof(u32));
+
+    T4_STSET_FN(t4_stset_rebuild)(self);
+}
+
+/*
+ * Called when the next insert would use more slots than the load factor allows, or entries are full with removed
+ * keys. If those are what is taking up the room, and dropping them would free at least an eighth of it, the set
+ * is rebuilt in place; otherwise it grows.
+ */
+static inline void T4_STSET_FN(t4_stset_make_room)(t4_stset_t * self) {
+    const size_t max = t4_stset_max_used(self->capacity, self->max_load_factor);
+
+    if (self->size < max - max / 8) {
+        T4_STSET_FN(t4_stset_rebuild)(self);
+    } else {
+        T4_STSET_FN(t4_stset_increase_capacity)(self);
+    }
+}
+
+/* Puts a key that is not in the set yet into the free slot i of its probe sequence, making room first if needed. */
+static inline void T4_STSET_FN(t4_stset_insert_at)(t4_stset_t * self, size_t i, const u64 hash, void * data, const size_t data_size) {
+    while (self->num_entries == self->entries_capacity) {
+        const size_t max = t4_stset_max_used(self->capacity, self->max_load_factor);
+
+        if (self->entries_capacity < max) {
+            self->entries_capacity = self->entries_capacity * 2 < max ? self->entries_capacity * 2 : max;
+            self->entries = t4_realloc(self->entries, self->entries_capacity, sizeof(t4_stset_entry_t));
+
+            if (self->value_size != 0) {
+                self->values = t4_realloc(self->values, self->entries_capacity, self->value_size);
+            }
+        } else {
+            /* Entries never need to hold more keys than the slots allow, so they are full of removed ones. */
+            T4_STSET_FN(t4_stset_make_room)(self);
+            i = T4_STSET_FN(t4_stset_find_free)(self, hash);
+        }
+    }
+
+    if (self->metadata[i] == T4_DELETED) {
+        /* Reusing a tombstone does not take up any more of the set. */
+        self->tombstones--;
+    } else {
+        if (self->growth_left == 0) {
+            T4_STSET_FN(t4_stset_make_room)(self);
+            i = T4_STSET_FN(t4_stset_find_free)(self, hash);
+        }
+
+        self->growth_left--;
+    }
+
+    self->size++;
+    t4_stset_put(self, i, hash, data, data_size);
+}
+
+static inline void T4_STSET_FN(t4_stset_insert_unchecked_with_hash)(t4_stset_t * self, const u64 hash, void * data, const size_t data_size) {
+    T4_STSET_FN(t4_stset_insert_at)(self, T4_STSET_FN(t4_stset_find_free)(self, hash), hash, data, data_size);
+}
+
+/* Returns the slot holding the key, or self->capacity if there is none. */
+static T4_INLINE size_t T4_STSET_FN(t4_stset_find_impl)(const t4_stset_t * self, const u64 hash, const void * data, const size_t data_size, const bool fold) {
+    const u8 h2 = T4_GET_H2(hash) | T4_FILLED;
+
+    t4_stset_probe_t probe = T4_STSET_FN(t4_stset_probe_start)(self, hash);
+
+    for (;; T4_STSET_FN(t4_stset_probe_next)(self, &probe)) {
+        const size_t i = probe.pos;
+        const T4_STSET_FN(t4_group) group = T4_STSET_FN(t4_group_load)(self->metadata + i);
+
+        for (u64 match = T4_STSET_FN(t4_group_match)(group, h2); match; match &= match - 1) {
+            const size_t j = i + T4_STSET_FN(t4_group_mask_first)(match);
+
+            if (T4_STSET_FN(t4_stset_entry_eq)(self, self->entries + self->index[j], data, data_size, fold)) {
+                return j;
+            }
+        }
+
+        if (T4_STSET_FN(t4_group_match_empty)(group)) {
+            return self->capacity;
+        }
+    }
+}
+
+static inline size_t T4_STSET_FN(t4_stset_find)(const t4_stset_t * self, const u64 hash, const void * data, const size_t data_size) {
+    return self->fold_case ? T4_STSET_FN(t4_stset_find_impl)(self, hash, data, data_size, true)
+                           : T4_STSET_FN(t4_stset_find_impl)(self, hash, data, data_size, false);
+}
+
+/* Returns the position in entries of the key, inserting it first if it is new. */
+static T4_INLINE size_t T4_STSET_FN(t4_stset_find_or_insert_impl)(t4_stset_t * self, const u64 hash, void * data, const size_t data_size, bool * inserted, const bool fold) {
+    const u8 h2 = T4_GET_H2(hash) | T4_FILLED;
+
+    t4_stset_probe_t probe = T4_STSET_FN(t4_stset_probe_start)(self, hash);
+
+    /* The first tombstone along the way, if any, is where the key goes once it is known to be new. */
+    size_t target = self->capacity;
+
+    for (;; T4_STSET_FN(t4_stset_probe_next)(self, &probe)) {
+        const size_t i = probe.pos;
+        const T4_STSET_FN(t4_group) group = T4_STSET_FN(t4_group_load)(self->metadata + i);
+
+        for (u64 match = T4_STSET_FN(t4_group_match)(group, h2); match; match &= match - 1) {
+            const size_t k = self->index[i + T4_STSET_FN(t4_group_mask_first)(match)];
+
+            if (T4_STSET_FN(t4_stset_entry_eq)(self, self->entries + k, data, data_size, fold)) {
+                *inserted = false;
+                return k;
+            }
+        }
+
+        const u64 avail = T4_STSET_FN(t4_group_match_free)(group);
+        if (avail && target == self->capacity) {
+            target = i + T4_STSET_FN(t4_group_mask_first)(avail);
+        }
+
+        if (T4_STSET_FN(t4_group_match_empty)(group)) {
+            T4_STSET_FN(t4_stset_insert_at)(self, target, hash, data, data_size);
+            *inserted = true;
+            return self->num_entries - 1;
+        }
+    }
+}
+
+static inline size_t T4_STSET_FN(t4_stset_find_or_insert)(t4_stset_t * self, const u64 hash, void * data, const size_t data_size, bool * inserted) {
+    return self->fold_case ? T4_STSET_FN(t4_stset_find_or_insert_impl)(self, hash, data, data_size, inserted, true)
+                           : T4_STSET_FN(t4_stset_find_or_insert_impl)(self, hash, data, data_size, inserted, false);
+}
+
+static inline bool T4_STSET_FN(t4_stset_try_insert_with_hash)(t4_stset_t * self, const u64 hash, void * data, const size_t data_size) {
+    bool inserted;
+    T4_STSET_FN(t4_stset_find_or_insert)(self, hash, data, data_size, &inserted);
+    return inserted;
+}
+
+static inline bool T4_STSET_FN(t4_stset_exists_with_hash)(const t4_stset_t * self, const u64 hash, const void * data, const size_t data_size) {
+    return T4_STSET_FN(t4_stset_find)(self, hash, data, data_size) != self->capacity;
+}
+
+static inline bool T4_STSET_FN(t4_stset_remove_with_hash)(t4_stset_t * self, const u64 hash, const void * data, const size_t data_size) {
+    const size_t i = T4_STSET_FN(t4_stset_find)(self, hash, data, data_size);
+    if (i == self->capacity) {
+        return false;
+    }
+
+    /* Stays in entries until the next rebuild, so the order of the others does not change. */
+    self->entries[self->index[i]].size = T4_STSET_REMOVED;
+
+    /* Every probe that reaches this group already ends here if it has an empty slot, so none is needed. */
+    const size_t group_start = T4_ALIGN_DOWN(i, T4_STSET_FN(t4_group_width));
+    if (T4_STSET_FN(t4_group_match_empty)(T4_STSET_FN(t4_group_load)(self->metadata + group_start))) {
+        self->metadata[i] = T4_EMPTY;
+        self->growth_left++;
+    } else {
+        self->metadata[i] = T4_DELETED;
+        self->tombstones++;
+    }
+
+    self->size--;
+    return true;
+}
+
+/* Same walk as find, but counts the groups it loads instead. */
+static inline size_t T4_STSET_FN(t4_stset_probe_length)(const t4_stset_t * self, const void * data, const size_t data_size) {
+    const u64 hash = t4_stset_hash_for(self, data, data_size);
+    const u8 h2 = T4_GET_H2(hash) | T4_FILLED;
+
+    t4_stset_probe_t probe = T4_STSET_FN(t4_stset_probe_start)(self, hash);
+
+    for (size_t groups = 1;; groups++, T4_STSET_FN(t4_stset_probe_next)(self, &probe)) {
+        const size_t i = probe.pos;
+        const T4_STSET_FN(t4_group) group = T4_STSET_FN(t4_group_load)(self->metadata + i);
+
+        for (u64 match = T4_STSET_FN(t4_group_match)(group, h2); match; match &= match - 1) {
+            if (T4_STSET_FN(t4_stset_entry_eq)(self, self->entries + self->index[i + T4_STSET_FN(t4_group_mask_first)(match)], data, data_size, self->fold_case)) {
+                return groups;
+            }
+        }
+
+        if (T4_STSET_FN(t4_group_match_empty)(group)) {
+            return groups;
+        }
+    }
+}
+
+static inline void T4_STSET_FN(t4_stset_insert_unchecked)(t4_stset_t * self, void * data, const size_t data_size) {
+    T4_STSET_FN(t4_stset_insert_unchecked_with_hash)(self, t4_stset_hash_for(self, data, data_size), data, data_size);
+}
+
+static inline bool T4_STSET_FN(t4_stset_try_insert)(t4_stset_t * self, void * data, const size_t data_size) {
+    return T4_STSET_FN(t4_stset_try_insert_with_hash)(self, t4_stset_hash_for(self, data, data_size), data, data_size);
+}
+
+static inline bool T4_STSET_FN(t4_stset_exists)(const t4_stset_t * self, const void * data, const size_t data_size) {
+    return T4_STSET_FN(t4_stset_exists_with_hash)(self, t4_stset_hash_for(self, data, data_size), data, data_size);
+}
+
+static inline bool T4_STSET_FN(t4_stset_remove)(t4_stset_t * self, const void * data, const size_t data_size) {
+    return T4_STSET_FN(t4_stset_remove_with_hash)(self, t4_stset_hash_for(self, data, data_size), data, data_size);
+}
+
+static inline void * T4_STSET_FN(t4_stset_map_upsert)(t4_stset_t * self, void * data, const size_t data_size, bool * inserted) {
+    bool dummy;
+    const size_t k = T4_STSET_FN(t4_stset_find_or_insert)(self, t4_stset_hash_for(self, data, data_size), data, data_size, inserted != NULL ? inserted : &dummy);
+
+    return self->values + k * self->value_size;
+}
+
+static inline void * T4_STSET_FN(t4_stset_map_get)(const t4_stset_t * self, const void * data, const size_t data_size) {
+    const size_t i = T4_STSET_FN(t4_stset_find)(self, t4_stset_hash_for(self, data, data_size), data, data_size);
+
+    return i == self->capacity ? NULL : self->values + self->index[i] * self->value_size;
+}
+
+static inline u32 T4_STSET_FN(t4_stset_try_insert_exists)(t4_stset_t * self, const t4_stset_t * other, void * data, const size_t data_size) {
+    const u64 hash = t4_stset_hash_for(self, data, data_size);
+
+    /* One hash for both sets only works if they hash alike. */
+    t4_debug_assert(self->fold_case == other->fold_case);
+
+    if (!T4_STSET_FN(t4_stset_try_insert_with_hash)(self, hash, data, data_size)) {
+        return 0;
+    }
+
+    return T4_STSET_INSERTED | (T4_STSET_FN(t4_stset_exists_with_hash)(other, hash, data, data_size) ? T4_STSET_IN_OTHER : 0);
+}
+
+/* Pulls in the first group of metadata and index a probe for hash will look at; the entry itself depends on both. */
+static inline void T4_STSET_FN(t4_stset_prefetch)(const t4_stset_t * self, const u64 hash) {
+    const size_t start = T4_STSET_FN(t4_stset_probe_start)(self, hash).pos;
+
+    __builtin_prefetch(self->metadata + start);
+    __builtin_prefetch(self->index + start);
+}
+
+/*
+ * The batch functions hash T4_STSET_BATCH keys and prefetch all of their probe starts before resolving any of
+ * them, so the cache misses of a whole batch overlap instead of being paid one after another. Like the probes they
+ * are written once for both values of fold_case, which is only looked at once per call.
+ */
+
+static T4_INLINE void T4_STSET_FN(t4_stset_exists_batch_impl)(const t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result, const bool fold) {
+    u64 hashes[T4_STSET_BATCH];
+
+    memset(result, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+
+    for (size_t base = 0; base < n; base += T4_STSET_BATCH) {
+        const size_t len = n - base < T4_STSET_BATCH ? n - base : T4_STSET_BATCH;
+
+        for (size_t i = 0; i < len; i++) {
+            hashes[i] = t4_make_hash_h1h2_for(keys[base + i].data, keys[base + i].size, fold);
+            T4_STSET_FN(t4_stset_prefetch)(self, hashes[i]);
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            const t4_stset_key_t * key = keys + base + i;
+            const u64 found = T4_STSET_FN(t4_stset_find_impl)(self, hashes[i], key->data, key->size, fold) != self->capacity;
+
+            result[(base + i) / 64] |= found << ((base + i) % 64);
+        }
+    }
+}
+
+static inline void T4_STSET_FN(t4_stset_exists_batch)(const t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    if (self->fold_case) {
+        T4_STSET_FN(t4_stset_exists_batch_impl)(self, keys, n, result, true);
+    } else {
+        T4_STSET_FN(t4_stset_exists_batch_impl)(self, keys, n, result, false);
+    }
+}
+
+/* Keys are inserted in order, so a key repeated within keys is only reported as new the first time. */
+static T4_INLINE void T4_STSET_FN(t4_stset_try_insert_batch_impl)(t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result, const bool fold) {
+    u64 hashes[T4_STSET_BATCH];
+
+    memset(result, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+
+    for (size_t base = 0; base < n; base += T4_STSET_BATCH) {
+        const size_t len = n - base < T4_STSET_BATCH ? n - base : T4_STSET_BATCH;
+
+        for (size_t i = 0; i < len; i++) {
+            hashes[i] = t4_make_hash_h1h2_for(keys[base + i].data, keys[base + i].size, fold);
+            T4_STSET_FN(t4_stset_prefetch)(self, hashes[i]);
+        }
+
+        /* A growth in the middle only makes the remaining prefetches useless, the probes start over from the hash. */
+        for (size_t i = 0; i < len; i++) {
+            const t4_stset_key_t * key = keys + base + i;
+            bool inserted;
+            T4_STSET_FN(t4_stset_find_or_insert_impl)(self, hashes[i], key->data, key->size, &inserted, fold);
+
+            result[(base + i) / 64] |= (u64)inserted << ((base + i) % 64);
+        }
+    }
+}
+
+static inline void T4_STSET_FN(t4_stset_try_insert_batch)(t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    if (self->fold_case) {
+        T4_STSET_FN(t4_stset_try_insert_batch_impl)(self, keys, n, result, true);
+    } else {
+        T4_STSET_FN(t4_stset_try_insert_batch_impl)(self, keys, n, result, false);
+    }
+}
+
+/*
+ * Every key is hashed once for both sets, and other is only probed (and prefetched) for the keys that turned out
+ * to be new, which in text is a small fraction of them.
+ */
+static T4_INLINE void T4_STSET_FN(t4_stset_try_insert_exists_batch_impl)(t4_stset_t * self, const t4_stset_t * other, const t4_stset_key_t * keys, const size_t n, u64 * inserted, u64 * in_other, const bool fold) {
+    u64 hashes[T4_STSET_BATCH];
+
+    size_t fresh[T4_STSET_BATCH];
+    size_t num_fresh;
+
+    memset(inserted, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+    memset(in_other, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+
+    for (size_t base = 0; base < n; base += T4_STSET_BATCH) {
+        const size_t len = n - base < T4_STSET_BATCH ? n - base : T4_STSET_BATCH;
+
+        for (size_t i = 0; i < len; i++) {
+            hashes[i] = t4_make_hash_h1h2_for(keys[base + i].data, keys[base + i].size, fold);
+            T4_STSET_FN(t4_stset_prefetch)(self, hashes[i]);
+        }
+
+        num_fresh = 0;
+        for (size_t i = 0; i < len; i++) {
+            const t4_stset_key_t * key = keys + base + i;
+
+            bool is_new;
+            T4_STSET_FN(t4_stset_find_or_insert_impl)(self, hashes[i], key->data, key->size, &is_new, fold);
+
+            if (is_new) {
+                inserted[(base + i) / 64] |= 1lu << ((base + i) % 64);
+
+                fresh[num_fresh++] = i;
+                T4_STSET_FN(t4_stset_prefetch)(other, hashes[i]);
+            }
+        }
+
+        for (size_t j = 0; j < num_fresh; j++) {
+            const size_t i = fresh[j];
+            const t4_stset_key_t * key = keys + base + i;
+            const u64 found = T4_STSET_FN(t4_stset_find_impl)(other, hashes[i], key->data, key->size, fold) != other->capacity;
+
+            in_other[(base + i) / 64] |= found << ((base + i) % 64);
+        }
+    }
+}
+
+static inline void T4_STSET_FN(t4_stset_try_insert_exists_batch)(t4_stset_t * self, const t4_stset_t * other, const t4_stset_key_t * keys, const size_t n, u64 * inserted, u64 * in_other) {
+    /* One hash for both sets only works if they hash alike. */
+    t4_debug_assert(self->fold_case == other->fold_case);
+
+    if (self->fold_case) {
+        T4_STSET_FN(t4_stset_try_insert_exists_batch_impl)(self, other, keys, n, inserted, in_other, true);
+    } else {
+        T4_STSET_FN(t4_stset_try_insert_exists_batch_impl)(self, other, keys, n, inserted, in_other, false);
+    }
+}
+
+#undef T4_STSET_BACKEND
@@ -9,6 +9,7 @@
 #include "t4/common.h"
 
 typedef struct t4_stset t4_stset_t;
+typedef struct t4_stset_key t4_stset_key_t;
 
 struct t4_internal_stset_vtable {
     size_t (*get_alignment)(void);
@@ -20,10 +21,57 @@ struct t4_internal_stset_vtable {
     bool (*try_insert)(t4_stset_t *, void *, size_t);
 
     bool (*exists)(const t4_stset_t *, const void *, size_t);
+
+    bool (*remove)(t4_stset_t *, const void *, size_t);
+
+    void (*insert_unchecked_with_hash)(t4_stset_t *, u64, void *, size_t);
+    bool (*try_insert_with_hash)(t4_stset_t *, u64, void *, size_t);
+    bool (*exists_with_hash)(const t4_stset_t *, u64, const void *, size_t);
+    bool (*remove_with_hash)(t4_stset_t *, u64, const void *, size_t);
+
+    u32 (*try_insert_exists)(t4_stset_t *, const t4_stset_t *, void *, size_t);
+
+    void (*try_insert_batch)(t4_stset_t *, const t4_stset_key_t *, size_t, u64 *);
+    void (*exists_batch)(const t4_stset_t *, const t4_stset_key_t *, size_t, u64 *);
+    void (*try_insert_exists_batch)(t4_stset_t *, const t4_stset_t *, const t4_stset_key_t *, size_t, u64 *, u64 *);
+
+    size_t (*probe_length)(const t4_stset_t *, const void *, size_t);
+
+    void * (*map_upsert)(t4_stset_t *, void *, size_t, bool *);
+    void * (*map_get)(const t4_stset_t *, const void *, size_t);
 };
 
 extern struct t4_internal_stset_vtable t4_internal_stset_vtable;
 
+/* Ordered from slowest to fastest. */
+enum t4_stset_isa {
+    T4_STSET_ISA_SCALAR,
+    T4_STSET_ISA_SSE2,
+    T4_STSET_ISA_AVX2,
+    T4_STSET_ISA_AVX512,
+
+    T4_STSET_ISA_COUNT,
+};
+
+/**
+ * Picks the fastest backend the CPU supports, unless the T4_STSET_ISA environment variable names
+ * another supported one (eg. T4_STSET_ISA=scalar).
+ */
 extern void t4_internal_stset_init(void);
 
+/**
+ * Forces a specific backend. Sets created with a different backend must not be used afterwards.
+ *
+ * @return false if the CPU does not support the backend, in which case nothing is changed
+ */
+extern bool t4_internal_stset_init_isa(enum t4_stset_isa isa);
+
+extern const char * t4_internal_stset_isa_name(enum t4_stset_isa isa);
+
+/* Defined by src/stset_<isa>.c, each built with only the flags of its own instruction set. */
+extern const struct t4_internal_stset_vtable t4_internal_stset_vtable_scalar;
+extern const struct t4_internal_stset_vtable t4_internal_stset_vtable_sse2;
+extern const struct t4_internal_stset_vtable t4_internal_stset_vtable_avx2;
+extern const struct t4_internal_stset_vtable t4_internal_stset_vtable_avx512;
+
 #endif /* T4_STSET_VTABLE_H_ */
\ No newline at end of file
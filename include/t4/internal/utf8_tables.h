@@ -0,0 +1,1156 @@
+/* Generated by gen_utf8_tables.py from Unicode 14.0.0, do not edit. */
+
+#ifndef T4_INTERNAL_UTF8_TABLES_H_
+#define T4_INTERNAL_UTF8_TABLES_H_
+
+#include "t4/common.h"
+
+typedef struct {
+    u32 first;
+    u32 last;
+} t4_utf8_range_t;
+
+typedef struct {
+    u32 first;
+    u32 last;
+    i32 delta;
+    u32 stride;
+} t4_utf8_fold_t;
+
+/* Non-ASCII code points that are part of words: letters and combining marks */
+static const t4_utf8_range_t t4_utf8_word_ranges[715] = {
+    { 0x000AA, 0x000AA },
+    { 0x000B5, 0x000B5 },
+    { 0x000BA, 0x000BA },
+    { 0x000C0, 0x000D6 },
+    { 0x000D8, 0x000F6 },
+    { 0x000F8, 0x002C1 },
+    { 0x002C6, 0x002D1 },
+    { 0x002E0, 0x002E4 },
+    { 0x002EC, 0x002EC },
+    { 0x002EE, 0x002EE },
+    { 0x00300, 0x00374 },
+    { 0x00376, 0x00377 },
+    { 0x0037A, 0x0037D },
+    { 0x0037F, 0x0037F },
+    { 0x00386, 0x00386 },
+    { 0x00388, 0x0038A },
+    { 0x0038C, 0x0038C },
+    { 0x0038E, 0x003A1 },
+    { 0x003A3, 0x003F5 },
+    { 0x003F7, 0x00481 },
+    { 0x00483, 0x00487 },
+    { 0x0048A, 0x0052F },
+    { 0x00531, 0x00556 },
+    { 0x00559, 0x00559 },
+    { 0x00560, 0x00588 },
+    { 0x00591, 0x005BD },
+    { 0x005BF, 0x005BF },
+    { 0x005C1, 0x005C2 },
+    { 0x005C4, 0x005C5 },
+    { 0x005C7, 0x005C7 },
+    { 0x005D0, 0x005EA },
+    { 0x005EF, 0x005F2 },
+    { 0x00610, 0x0061A },
+    { 0x00620, 0x0065F },
+    { 0x0066E, 0x006D3 },
+    { 0x006D5, 0x006DC },
+    { 0x006DF, 0x006E8 },
+    { 0x006EA, 0x006EF },
+    { 0x006FA, 0x006FC },
+    { 0x006FF, 0x006FF },
+    { 0x00710, 0x0074A },
+    { 0x0074D, 0x007B1 },
+    { 0x007CA, 0x007F5 },
+    { 0x007FA, 0x007FA },
+    { 0x007FD, 0x007FD },
+    { 0x00800, 0x0082D },
+    { 0x00840, 0x0085B },
+    { 0x00860, 0x0086A },
+    { 0x00870, 0x00887 },
+    { 0x00889, 0x0088E },
+    { 0x00898, 0x008E1 },
+    { 0x008E3, 0x00963 },
+    { 0x00971, 0x00983 },
+    { 0x00985, 0x0098C },
+    { 0x0098F, 0x00990 },
+    { 0x00993, 0x009A8 },
+    { 0x009AA, 0x009B0 },
+    { 0x009B2, 0x009B2 },
+    { 0x009B6, 0x009B9 },
+    { 0x009BC, 0x009C4 },
+    { 0x009C7, 0x009C8 },
+    { 0x009CB, 0x009CE },
+    { 0x009D7, 0x009D7 },
+    { 0x009DC, 0x009DD },
+    { 0x009DF, 0x009E3 },
+    { 0x009F0, 0x009F1 },
+    { 0x009FC, 0x009FC },
+    { 0x009FE, 0x009FE },
+    { 0x00A01, 0x00A03 },
+    { 0x00A05, 0x00A0A },
+    { 0x00A0F, 0x00A10 },
+    { 0x00A13, 0x00A28 },
+    { 0x00A2A, 0x00A30 },
+    { 0x00A32, 0x00A33 },
+    { 0x00A35, 0x00A36 },
+    { 0x00A38, 0x00A39 },
+    { 0x00A3C, 0x00A3C },
+    { 0x00A3E, 0x00A42 },
+    { 0x00A47, 0x00A48 },
+    { 0x00A4B, 0x00A4D },
+    { 0x00A51, 0x00A51 },
+    { 0x00A59, 0x00A5C },
+    { 0x00A5E, 0x00A5E },
+    { 0x00A70, 0x00A75 },
+    { 0x00A81, 0x00A83 },
+    { 0x00A85, 0x00A8D },
+    { 0x00A8F, 0x00A91 },
+    { 0x00A93, 0x00AA8 },
+    { 0x00AAA, 0x00AB0 },
+    { 0x00AB2, 0x00AB3 },
+    { 0x00AB5, 0x00AB9 },
+    { 0x00ABC, 0x00AC5 },
+    { 0x00AC7, 0x00AC9 },
+    { 0x00ACB, 0x00ACD },
+    { 0x00AD0, 0x00AD0 },
+    { 0x00AE0, 0x00AE3 },
+    { 0x00AF9, 0x00AFF },
+    { 0x00B01, 0x00B03 },
+    { 0x00B05, 0x00B0C },
+    { 0x00B0F, 0x00B10 },
+    { 0x00B13, 0x00B28 },
+    { 0x00B2A, 0x00B30 },
+    { 0x00B32, 0x00B33 },
+    { 0x00B35, 0x00B39 },
+    { 0x00B3C, 0x00B44 },
+    { 0x00B47, 0x00B48 },
+    { 0x00B4B, 0x00B4D },
+    { 0x00B55, 0x00B57 },
+    { 0x00B5C, 0x00B5D },
+    { 0x00B5F, 0x00B63 },
+    { 0x00B71, 0x00B71 },
+    { 0x00B82, 0x00B83 },
+    { 0x00B85, 0x00B8A },
+    { 0x00B8E, 0x00B90 },
+    { 0x00B92, 0x00B95 },
+    { 0x00B99, 0x00B9A },
+    { 0x00B9C, 0x00B9C },
+    { 0x00B9E, 0x00B9F },
+    { 0x00BA3, 0x00BA4 },
+    { 0x00BA8, 0x00BAA },
+    { 0x00BAE, 0x00BB9 },
+    { 0x00BBE, 0x00BC2 },
+    { 0x00BC6, 0x00BC8 },
+    { 0x00BCA, 0x00BCD },
+    { 0x00BD0, 0x00BD0 },
+    { 0x00BD7, 0x00BD7 },
+    { 0x00C00, 0x00C0C },
+    { 0x00C0E, 0x00C10 },
+    { 0x00C12, 0x00C28 },
+    { 0x00C2A, 0x00C39 },
+    { 0x00C3C, 0x00C44 },
+    { 0x00C46, 0x00C48 },
+    { 0x00C4A, 0x00C4D },
+    { 0x00C55, 0x00C56 },
+    { 0x00C58, 0x00C5A },
+    { 0x00C5D, 0x00C5D },
+    { 0x00C60, 0x00C63 },
+    { 0x00C80, 0x00C83 },
+    { 0x00C85, 0x00C8C },
+    { 0x00C8E, 0x00C90 },
+    { 0x00C92, 0x00CA8 },
+    { 0x00CAA, 0x00CB3 },
+    { 0x00CB5, 0x00CB9 },
+    { 0x00CBC, 0x00CC4 },
+    { 0x00CC6, 0x00CC8 },
+    { 0x00CCA, 0x00CCD },
+    { 0x00CD5, 0x00CD6 },
+    { 0x00CDD, 0x00CDE },
+    { 0x00CE0, 0x00CE3 },
+    { 0x00CF1, 0x00CF2 },
+    { 0x00D00, 0x00D0C },
+    { 0x00D0E, 0x00D10 },
+    { 0x00D12, 0x00D44 },
+    { 0x00D46, 0x00D48 },
+    { 0x00D4A, 0x00D4E },
+    { 0x00D54, 0x00D57 },
+    { 0x00D5F, 0x00D63 },
+    { 0x00D7A, 0x00D7F },
+    { 0x00D81, 0x00D83 },
+    { 0x00D85, 0x00D96 },
+    { 0x00D9A, 0x00DB1 },
+    { 0x00DB3, 0x00DBB },
+    { 0x00DBD, 0x00DBD },
+    { 0x00DC0, 0x00DC6 },
+    { 0x00DCA, 0x00DCA },
+    { 0x00DCF, 0x00DD4 },
+    { 0x00DD6, 0x00DD6 },
+    { 0x00DD8, 0x00DDF },
+    { 0x00DF2, 0x00DF3 },
+    { 0x00E01, 0x00E3A },
+    { 0x00E40, 0x00E4E },
+    { 0x00E81, 0x00E82 },
+    { 0x00E84, 0x00E84 },
+    { 0x00E86, 0x00E8A },
+    { 0x00E8C, 0x00EA3 },
+    { 0x00EA5, 0x00EA5 },
+    { 0x00EA7, 0x00EBD },
+    { 0x00EC0, 0x00EC4 },
+    { 0x00EC6, 0x00EC6 },
+    { 0x00EC8, 0x00ECD },
+    { 0x00EDC, 0x00EDF },
+    { 0x00F00, 0x00F00 },
+    { 0x00F18, 0x00F19 },
+    { 0x00F35, 0x00F35 },
+    { 0x00F37, 0x00F37 },
+    { 0x00F39, 0x00F39 },
+    { 0x00F3E, 0x00F47 },
+    { 0x00F49, 0x00F6C },
+    { 0x00F71, 0x00F84 },
+    { 0x00F86, 0x00F97 },
+    { 0x00F99, 0x00FBC },
+    { 0x00FC6, 0x00FC6 },
+    { 0x01000, 0x0103F },
+    { 0x01050, 0x0108F },
+    { 0x0109A, 0x0109D },
+    { 0x010A0, 0x010C5 },
+    { 0x010C7, 0x010C7 },
+    { 0x010CD, 0x010CD },
+    { 0x010D0, 0x010FA },
+    { 0x010FC, 0x01248 },
+    { 0x0124A, 0x0124D },
+    { 0x01250, 0x01256 },
+    { 0x01258, 0x01258 },
+    { 0x0125A, 0x0125D },
+    { 0x01260, 0x01288 },
+    { 0x0128A, 0x0128D },
+    { 0x01290, 0x012B0 },
+    { 0x012B2, 0x012B5 },
+    { 0x012B8, 0x012BE },
+    { 0x012C0, 0x012C0 },
+    { 0x012C2, 0x012C5 },
+    { 0x012C8, 0x012D6 },
+    { 0x012D8, 0x01310 },
+    { 0x01312, 0x01315 },
+    { 0x01318, 0x0135A },
+    { 0x0135D, 0x0135F },
+    { 0x01380, 0x0138F },
+    { 0x013A0, 0x013F5 },
+    { 0x013F8, 0x013FD },
+    { 0x01401, 0x0166C },
+    { 0x0166F, 0x0167F },
+    { 0x01681, 0x0169A },
+    { 0x016A0, 0x016EA },
+    { 0x016F1, 0x016F8 },
+    { 0x01700, 0x01715 },
+    { 0x0171F, 0x01734 },
+    { 0x01740, 0x01753 },
+    { 0x01760, 0x0176C },
+    { 0x0176E, 0x01770 },
+    { 0x01772, 0x01773 },
+    { 0x01780, 0x017D3 },
+    { 0x017D7, 0x017D7 },
+    { 0x017DC, 0x017DD },
+    { 0x0180B, 0x0180D },
+    { 0x0180F, 0x0180F },
+    { 0x01820, 0x01878 },
+    { 0x01880, 0x018AA },
+    { 0x018B0, 0x018F5 },
+    { 0x01900, 0x0191E },
+    { 0x01920, 0x0192B },
+    { 0x01930, 0x0193B },
+    { 0x01950, 0x0196D },
+    { 0x01970, 0x01974 },
+    { 0x01980, 0x019AB },
+    { 0x019B0, 0x019C9 },
+    { 0x01A00, 0x01A1B },
+    { 0x01A20, 0x01A5E },
+    { 0x01A60, 0x01A7C },
+    { 0x01A7F, 0x01A7F },
+    { 0x01AA7, 0x01AA7 },
+    { 0x01AB0, 0x01ABD },
+    { 0x01ABF, 0x01ACE },
+    { 0x01B00, 0x01B4C },
+    { 0x01B6B, 0x01B73 },
+    { 0x01B80, 0x01BAF },
+    { 0x01BBA, 0x01BF3 },
+    { 0x01C00, 0x01C37 },
+    { 0x01C4D, 0x01C4F },
+    { 0x01C5A, 0x01C7D },
+    { 0x01C80, 0x01C88 },
+    { 0x01C90, 0x01CBA },
+    { 0x01CBD, 0x01CBF },
+    { 0x01CD0, 0x01CD2 },
+    { 0x01CD4, 0x01CFA },
+    { 0x01D00, 0x01F15 },
+    { 0x01F18, 0x01F1D },
+    { 0x01F20, 0x01F45 },
+    { 0x01F48, 0x01F4D },
+    { 0x01F50, 0x01F57 },
+    { 0x01F59, 0x01F59 },
+    { 0x01F5B, 0x01F5B },
+    { 0x01F5D, 0x01F5D },
+    { 0x01F5F, 0x01F7D },
+    { 0x01F80, 0x01FB4 },
+    { 0x01FB6, 0x01FBC },
+    { 0x01FBE, 0x01FBE },
+    { 0x01FC2, 0x01FC4 },
+    { 0x01FC6, 0x01FCC },
+    { 0x01FD0, 0x01FD3 },
+    { 0x01FD6, 0x01FDB },
+    { 0x01FE0, 0x01FEC },
+    { 0x01FF2, 0x01FF4 },
+    { 0x01FF6, 0x01FFC },
+    { 0x02071, 0x02071 },
+    { 0x0207F, 0x0207F },
+    { 0x02090, 0x0209C },
+    { 0x020D0, 0x020DC },
+    { 0x020E1, 0x020E1 },
+    { 0x020E5, 0x020F0 },
+    { 0x02102, 0x02102 },
+    { 0x02107, 0x02107 },
+    { 0x0210A, 0x02113 },
+    { 0x02115, 0x02115 },
+    { 0x02119, 0x0211D },
+    { 0x02124, 0x02124 },
+    { 0x02126, 0x02126 },
+    { 0x02128, 0x02128 },
+    { 0x0212A, 0x0212D },
+    { 0x0212F, 0x02139 },
+    { 0x0213C, 0x0213F },
+    { 0x02145, 0x02149 },
+    { 0x0214E, 0x0214E },
+    { 0x02183, 0x02184 },
+    { 0x02C00, 0x02CE4 },
+    { 0x02CEB, 0x02CF3 },
+    { 0x02D00, 0x02D25 },
+    { 0x02D27, 0x02D27 },
+    { 0x02D2D, 0x02D2D },
+    { 0x02D30, 0x02D67 },
+    { 0x02D6F, 0x02D6F },
+    { 0x02D7F, 0x02D96 },
+    { 0x02DA0, 0x02DA6 },
+    { 0x02DA8, 0x02DAE },
+    { 0x02DB0, 0x02DB6 },
+    { 0x02DB8, 0x02DBE },
+    { 0x02DC0, 0x02DC6 },
+    { 0x02DC8, 0x02DCE },
+    { 0x02DD0, 0x02DD6 },
+    { 0x02DD8, 0x02DDE },
+    { 0x02DE0, 0x02DFF },
+    { 0x02E2F, 0x02E2F },
+    { 0x03005, 0x03006 },
+    { 0x0302A, 0x0302F },
+    { 0x03031, 0x03035 },
+    { 0x0303B, 0x0303C },
+    { 0x03041, 0x03096 },
+    { 0x03099, 0x0309A },
+    { 0x0309D, 0x0309F },
+    { 0x030A1, 0x030FA },
+    { 0x030FC, 0x030FF },
+    { 0x03105, 0x0312F },
+    { 0x03131, 0x0318E },
+    { 0x031A0, 0x031BF },
+    { 0x031F0, 0x031FF },
+    { 0x03400, 0x04DBF },
+    { 0x04E00, 0x0A48C },
+    { 0x0A4D0, 0x0A4FD },
+    { 0x0A500, 0x0A60C },
+    { 0x0A610, 0x0A61F },
+    { 0x0A62A, 0x0A62B },
+    { 0x0A640, 0x0A66F },
+    { 0x0A674, 0x0A67D },
+    { 0x0A67F, 0x0A6E5 },
+    { 0x0A6F0, 0x0A6F1 },
+    { 0x0A717, 0x0A71F },
+    { 0x0A722, 0x0A788 },
+    { 0x0A78B, 0x0A7CA },
+    { 0x0A7D0, 0x0A7D1 },
+    { 0x0A7D3, 0x0A7D3 },
+    { 0x0A7D5, 0x0A7D9 },
+    { 0x0A7F2, 0x0A827 },
+    { 0x0A82C, 0x0A82C },
+    { 0x0A840, 0x0A873 },
+    { 0x0A880, 0x0A8C5 },
+    { 0x0A8E0, 0x0A8F7 },
+    { 0x0A8FB, 0x0A8FB },
+    { 0x0A8FD, 0x0A8FF },
+    { 0x0A90A, 0x0A92D },
+    { 0x0A930, 0x0A953 },
+    { 0x0A960, 0x0A97C },
+    { 0x0A980, 0x0A9C0 },
+    { 0x0A9CF, 0x0A9CF },
+    { 0x0A9E0, 0x0A9EF },
+    { 0x0A9FA, 0x0A9FE },
+    { 0x0AA00, 0x0AA36 },
+    { 0x0AA40, 0x0AA4D },
+    { 0x0AA60, 0x0AA76 },
+    { 0x0AA7A, 0x0AAC2 },
+    { 0x0AADB, 0x0AADD },
+    { 0x0AAE0, 0x0AAEF },
+    { 0x0AAF2, 0x0AAF6 },
+    { 0x0AB01, 0x0AB06 },
+    { 0x0AB09, 0x0AB0E },
+    { 0x0AB11, 0x0AB16 },
+    { 0x0AB20, 0x0AB26 },
+    { 0x0AB28, 0x0AB2E },
+    { 0x0AB30, 0x0AB5A },
+    { 0x0AB5C, 0x0AB69 },
+    { 0x0AB70, 0x0ABEA },
+    { 0x0ABEC, 0x0ABED },
+    { 0x0AC00, 0x0D7A3 },
+    { 0x0D7B0, 0x0D7C6 },
+    { 0x0D7CB, 0x0D7FB },
+    { 0x0F900, 0x0FA6D },
+    { 0x0FA70, 0x0FAD9 },
+    { 0x0FB00, 0x0FB06 },
+    { 0x0FB13, 0x0FB17 },
+    { 0x0FB1D, 0x0FB28 },
+    { 0x0FB2A, 0x0FB36 },
+    { 0x0FB38, 0x0FB3C },
+    { 0x0FB3E, 0x0FB3E },
+    { 0x0FB40, 0x0FB41 },
+    { 0x0FB43, 0x0FB44 },
+    { 0x0FB46, 0x0FBB1 },
+    { 0x0FBD3, 0x0FD3D },
+    { 0x0FD50, 0x0FD8F },
+    { 0x0FD92, 0x0FDC7 },
+    { 0x0FDF0, 0x0FDFB },
+    { 0x0FE00, 0x0FE0F },
+    { 0x0FE20, 0x0FE2F },
+    { 0x0FE70, 0x0FE74 },
+    { 0x0FE76, 0x0FEFC },
+    { 0x0FF21, 0x0FF3A },
+    { 0x0FF41, 0x0FF5A },
+    { 0x0FF66, 0x0FFBE },
+    { 0x0FFC2, 0x0FFC7 },
+    { 0x0FFCA, 0x0FFCF },
+    { 0x0FFD2, 0x0FFD7 },
+    { 0x0FFDA, 0x0FFDC },
+    { 0x10000, 0x1000B },
+    { 0x1000D, 0x10026 },
+    { 0x10028, 0x1003A },
+    { 0x1003C, 0x1003D },
+    { 0x1003F, 0x1004D },
+    { 0x10050, 0x1005D },
+    { 0x10080, 0x100FA },
+    { 0x101FD, 0x101FD },
+    { 0x10280, 0x1029C },
+    { 0x102A0, 0x102D0 },
+    { 0x102E0, 0x102E0 },
+    { 0x10300, 0x1031F },
+    { 0x1032D, 0x10340 },
+    { 0x10342, 0x10349 },
+    { 0x10350, 0x1037A },
+    { 0x10380, 0x1039D },
+    { 0x103A0, 0x103C3 },
+    { 0x103C8, 0x103CF },
+    { 0x10400, 0x1049D },
+    { 0x104B0, 0x104D3 },
+    { 0x104D8, 0x104FB },
+    { 0x10500, 0x10527 },
+    { 0x10530, 0x10563 },
+    { 0x10570, 0x1057A },
+    { 0x1057C, 0x1058A },
+    { 0x1058C, 0x10592 },
+    { 0x10594, 0x10595 },
+    { 0x10597, 0x105A1 },
+    { 0x105A3, 0x105B1 },
+    { 0x105B3, 0x105B9 },
+    { 0x105BB, 0x105BC },
+    { 0x10600, 0x10736 },
+    { 0x10740, 0x10755 },
+    { 0x10760, 0x10767 },
+    { 0x10780, 0x10785 },
+    { 0x10787, 0x107B0 },
+    { 0x107B2, 0x107BA },
+    { 0x10800, 0x10805 },
+    { 0x10808, 0x10808 },
+    { 0x1080A, 0x10835 },
+    { 0x10837, 0x10838 },
+    { 0x1083C, 0x1083C },
+    { 0x1083F, 0x10855 },
+    { 0x10860, 0x10876 },
+    { 0x10880, 0x1089E },
+    { 0x108E0, 0x108F2 },
+    { 0x108F4, 0x108F5 },
+    { 0x10900, 0x10915 },
+    { 0x10920, 0x10939 },
+    { 0x10980, 0x109B7 },
+    { 0x109BE, 0x109BF },
+    { 0x10A00, 0x10A03 },
+    { 0x10A05, 0x10A06 },
+    { 0x10A0C, 0x10A13 },
+    { 0x10A15, 0x10A17 },
+    { 0x10A19, 0x10A35 },
+    { 0x10A38, 0x10A3A },
+    { 0x10A3F, 0x10A3F },
+    { 0x10A60, 0x10A7C },
+    { 0x10A80, 0x10A9C },
+    { 0x10AC0, 0x10AC7 },
+    { 0x10AC9, 0x10AE6 },
+    { 0x10B00, 0x10B35 },
+    { 0x10B40, 0x10B55 },
+    { 0x10B60, 0x10B72 },
+    { 0x10B80, 0x10B91 },
+    { 0x10C00, 0x10C48 },
+    { 0x10C80, 0x10CB2 },
+    { 0x10CC0, 0x10CF2 },
+    { 0x10D00, 0x10D27 },
+    { 0x10E80, 0x10EA9 },
+    { 0x10EAB, 0x10EAC },
+    { 0x10EB0, 0x10EB1 },
+    { 0x10F00, 0x10F1C },
+    { 0x10F27, 0x10F27 },
+    { 0x10F30, 0x10F50 },
+    { 0x10F70, 0x10F85 },
+    { 0x10FB0, 0x10FC4 },
+    { 0x10FE0, 0x10FF6 },
+    { 0x11000, 0x11046 },
+    { 0x11070, 0x11075 },
+    { 0x1107F, 0x110BA },
+    { 0x110C2, 0x110C2 },
+    { 0x110D0, 0x110E8 },
+    { 0x11100, 0x11134 },
+    { 0x11144, 0x11147 },
+    { 0x11150, 0x11173 },
+    { 0x11176, 0x11176 },
+    { 0x11180, 0x111C4 },
+    { 0x111C9, 0x111CC },
+    { 0x111CE, 0x111CF },
+    { 0x111DA, 0x111DA },
+    { 0x111DC, 0x111DC },
+    { 0x11200, 0x11211 },
+    { 0x11213, 0x11237 },
+    { 0x1123E, 0x1123E },
+    { 0x11280, 0x11286 },
+    { 0x11288, 0x11288 },
+    { 0x1128A, 0x1128D },
+    { 0x1128F, 0x1129D },
+    { 0x1129F, 0x112A8 },
+    { 0x112B0, 0x112EA },
+    { 0x11300, 0x11303 },
+    { 0x11305, 0x1130C },
+    { 0x1130F, 0x11310 },
+    { 0x11313, 0x11328 },
+    { 0x1132A, 0x11330 },
+    { 0x11332, 0x11333 },
+    { 0x11335, 0x11339 },
+    { 0x1133B, 0x11344 },
+    { 0x11347, 0x11348 },
+    { 0x1134B, 0x1134D },
+    { 0x11350, 0x11350 },
+    { 0x11357, 0x11357 },
+    { 0x1135D, 0x11363 },
+    { 0x11366, 0x1136C },
+    { 0x11370, 0x11374 },
+    { 0x11400, 0x1144A },
+    { 0x1145E, 0x11461 },
+    { 0x11480, 0x114C5 },
+    { 0x114C7, 0x114C7 },
+    { 0x11580, 0x115B5 },
+    { 0x115B8, 0x115C0 },
+    { 0x115D8, 0x115DD },
+    { 0x11600, 0x11640 },
+    { 0x11644, 0x11644 },
+    { 0x11680, 0x116B8 },
+    { 0x11700, 0x1171A },
+    { 0x1171D, 0x1172B },
+    { 0x11740, 0x11746 },
+    { 0x11800, 0x1183A },
+    { 0x118A0, 0x118DF },
+    { 0x118FF, 0x11906 },
+    { 0x11909, 0x11909 },
+    { 0x1190C, 0x11913 },
+    { 0x11915, 0x11916 },
+    { 0x11918, 0x11935 },
+    { 0x11937, 0x11938 },
+    { 0x1193B, 0x11943 },
+    { 0x119A0, 0x119A7 },
+    { 0x119AA, 0x119D7 },
+    { 0x119DA, 0x119E1 },
+    { 0x119E3, 0x119E4 },
+    { 0x11A00, 0x11A3E },
+    { 0x11A47, 0x11A47 },
+    { 0x11A50, 0x11A99 },
+    { 0x11A9D, 0x11A9D },
+    { 0x11AB0, 0x11AF8 },
+    { 0x11C00, 0x11C08 },
+    { 0x11C0A, 0x11C36 },
+    { 0x11C38, 0x11C40 },
+    { 0x11C72, 0x11C8F },
+    { 0x11C92, 0x11CA7 },
+    { 0x11CA9, 0x11CB6 },
+    { 0x11D00, 0x11D06 },
+    { 0x11D08, 0x11D09 },
+    { 0x11D0B, 0x11D36 },
+    { 0x11D3A, 0x11D3A },
+    { 0x11D3C, 0x11D3D },
+    { 0x11D3F, 0x11D47 },
+    { 0x11D60, 0x11D65 },
+    { 0x11D67, 0x11D68 },
+    { 0x11D6A, 0x11D8E },
+    { 0x11D90, 0x11D91 },
+    { 0x11D93, 0x11D98 },
+    { 0x11EE0, 0x11EF6 },
+    { 0x11FB0, 0x11FB0 },
+    { 0x12000, 0x12399 },
+    { 0x12480, 0x12543 },
+    { 0x12F90, 0x12FF0 },
+    { 0x13000, 0x1342E },
+    { 0x14400, 0x14646 },
+    { 0x16800, 0x16A38 },
+    { 0x16A40, 0x16A5E },
+    { 0x16A70, 0x16ABE },
+    { 0x16AD0, 0x16AED },
+    { 0x16AF0, 0x16AF4 },
+    { 0x16B00, 0x16B36 },
+    { 0x16B40, 0x16B43 },
+    { 0x16B63, 0x16B77 },
+    { 0x16B7D, 0x16B8F },
+    { 0x16E40, 0x16E7F },
+    { 0x16F00, 0x16F4A },
+    { 0x16F4F, 0x16F87 },
+    { 0x16F8F, 0x16F9F },
+    { 0x16FE0, 0x16FE1 },
+    { 0x16FE3, 0x16FE4 },
+    { 0x16FF0, 0x16FF1 },
+    { 0x17000, 0x187F7 },
+    { 0x18800, 0x18CD5 },
+    { 0x18D00, 0x18D08 },
+    { 0x1AFF0, 0x1AFF3 },
+    { 0x1AFF5, 0x1AFFB },
+    { 0x1AFFD, 0x1AFFE },
+    { 0x1B000, 0x1B122 },
+    { 0x1B150, 0x1B152 },
+    { 0x1B164, 0x1B167 },
+    { 0x1B170, 0x1B2FB },
+    { 0x1BC00, 0x1BC6A },
+    { 0x1BC70, 0x1BC7C },
+    { 0x1BC80, 0x1BC88 },
+    { 0x1BC90, 0x1BC99 },
+    { 0x1BC9D, 0x1BC9E },
+    { 0x1CF00, 0x1CF2D },
+    { 0x1CF30, 0x1CF46 },
+    { 0x1D165, 0x1D169 },
+    { 0x1D16D, 0x1D172 },
+    { 0x1D17B, 0x1D182 },
+    { 0x1D185, 0x1D18B },
+    { 0x1D1AA, 0x1D1AD },
+    { 0x1D242, 0x1D244 },
+    { 0x1D400, 0x1D454 },
+    { 0x1D456, 0x1D49C },
+    { 0x1D49E, 0x1D49F },
+    { 0x1D4A2, 0x1D4A2 },
+    { 0x1D4A5, 0x1D4A6 },
+    { 0x1D4A9, 0x1D4AC },
+    { 0x1D4AE, 0x1D4B9 },
+    { 0x1D4BB, 0x1D4BB },
+    { 0x1D4BD, 0x1D4C3 },
+    { 0x1D4C5, 0x1D505 },
+    { 0x1D507, 0x1D50A },
+    { 0x1D50D, 0x1D514 },
+    { 0x1D516, 0x1D51C },
+    { 0x1D51E, 0x1D539 },
+    { 0x1D53B, 0x1D53E },
+    { 0x1D540, 0x1D544 },
+    { 0x1D546, 0x1D546 },
+    { 0x1D54A, 0x1D550 },
+    { 0x1D552, 0x1D6A5 },
+    { 0x1D6A8, 0x1D6C0 },
+    { 0x1D6C2, 0x1D6DA },
+    { 0x1D6DC, 0x1D6FA },
+    { 0x1D6FC, 0x1D714 },
+    { 0x1D716, 0x1D734 },
+    { 0x1D736, 0x1D74E },
+    { 0x1D750, 0x1D76E },
+    { 0x1D770, 0x1D788 },
+    { 0x1D78A, 0x1D7A8 },
+    { 0x1D7AA, 0x1D7C2 },
+    { 0x1D7C4, 0x1D7CB },
+    { 0x1DA00, 0x1DA36 },
+    { 0x1DA3B, 0x1DA6C },
+    { 0x1DA75, 0x1DA75 },
+    { 0x1DA84, 0x1DA84 },
+    { 0x1DA9B, 0x1DA9F },
+    { 0x1DAA1, 0x1DAAF },
+    { 0x1DF00, 0x1DF1E },
+    { 0x1E000, 0x1E006 },
+    { 0x1E008, 0x1E018 },
+    { 0x1E01B, 0x1E021 },
+    { 0x1E023, 0x1E024 },
+    { 0x1E026, 0x1E02A },
+    { 0x1E100, 0x1E12C },
+    { 0x1E130, 0x1E13D },
+    { 0x1E14E, 0x1E14E },
+    { 0x1E290, 0x1E2AE },
+    { 0x1E2C0, 0x1E2EF },
+    { 0x1E7E0, 0x1E7E6 },
+    { 0x1E7E8, 0x1E7EB },
+    { 0x1E7ED, 0x1E7EE },
+    { 0x1E7F0, 0x1E7FE },
+    { 0x1E800, 0x1E8C4 },
+    { 0x1E8D0, 0x1E8D6 },
+    { 0x1E900, 0x1E94B },
+    { 0x1EE00, 0x1EE03 },
+    { 0x1EE05, 0x1EE1F },
+    { 0x1EE21, 0x1EE22 },
+    { 0x1EE24, 0x1EE24 },
+    { 0x1EE27, 0x1EE27 },
+    { 0x1EE29, 0x1EE32 },
+    { 0x1EE34, 0x1EE37 },
+    { 0x1EE39, 0x1EE39 },
+    { 0x1EE3B, 0x1EE3B },
+    { 0x1EE42, 0x1EE42 },
+    { 0x1EE47, 0x1EE47 },
+    { 0x1EE49, 0x1EE49 },
+    { 0x1EE4B, 0x1EE4B },
+    { 0x1EE4D, 0x1EE4F },
+    { 0x1EE51, 0x1EE52 },
+    { 0x1EE54, 0x1EE54 },
+    { 0x1EE57, 0x1EE57 },
+    { 0x1EE59, 0x1EE59 },
+    { 0x1EE5B, 0x1EE5B },
+    { 0x1EE5D, 0x1EE5D },
+    { 0x1EE5F, 0x1EE5F },
+    { 0x1EE61, 0x1EE62 },
+    { 0x1EE64, 0x1EE64 },
+    { 0x1EE67, 0x1EE6A },
+    { 0x1EE6C, 0x1EE72 },
+    { 0x1EE74, 0x1EE77 },
+    { 0x1EE79, 0x1EE7C },
+    { 0x1EE7E, 0x1EE7E },
+    { 0x1EE80, 0x1EE89 },
+    { 0x1EE8B, 0x1EE9B },
+    { 0x1EEA1, 0x1EEA3 },
+    { 0x1EEA5, 0x1EEA9 },
+    { 0x1EEAB, 0x1EEBB },
+    { 0x20000, 0x2A6DF },
+    { 0x2A700, 0x2B738 },
+    { 0x2B740, 0x2B81D },
+    { 0x2B820, 0x2CEA1 },
+    { 0x2CEB0, 0x2EBE0 },
+    { 0x2F800, 0x2FA1D },
+    { 0x30000, 0x3134A },
+    { 0xE0100, 0xE01EF },
+};
+
+/* U+0080 to U+07FF at [cp - 0x80]: the folded code point, | 0x8000 if it is part of words */
+static const u16 t4_utf8_two_byte[1920] = {
+    0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+    0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+    0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+    0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x80AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+    0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x83BC, 0x00B6, 0x00B7,
+    0x00B8, 0x00B9, 0x80BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+    0x80E0, 0x80E1, 0x80E2, 0x80E3, 0x80E4, 0x80E5, 0x80E6, 0x80E7,
+    0x80E8, 0x80E9, 0x80EA, 0x80EB, 0x80EC, 0x80ED, 0x80EE, 0x80EF,
+    0x80F0, 0x80F1, 0x80F2, 0x80F3, 0x80F4, 0x80F5, 0x80F6, 0x00D7,
+    0x80F8, 0x80F9, 0x80FA, 0x80FB, 0x80FC, 0x80FD, 0x80FE, 0x80DF,
+    0x80E0, 0x80E1, 0x80E2, 0x80E3, 0x80E4, 0x80E5, 0x80E6, 0x80E7,
+    0x80E8, 0x80E9, 0x80EA, 0x80EB, 0x80EC, 0x80ED, 0x80EE, 0x80EF,
+    0x80F0, 0x80F1, 0x80F2, 0x80F3, 0x80F4, 0x80F5, 0x80F6, 0x00F7,
+    0x80F8, 0x80F9, 0x80FA, 0x80FB, 0x80FC, 0x80FD, 0x80FE, 0x80FF,
+    0x8101, 0x8101, 0x8103, 0x8103, 0x8105, 0x8105, 0x8107, 0x8107,
+    0x8109, 0x8109, 0x810B, 0x810B, 0x810D, 0x810D, 0x810F, 0x810F,
+    0x8111, 0x8111, 0x8113, 0x8113, 0x8115, 0x8115, 0x8117, 0x8117,
+    0x8119, 0x8119, 0x811B, 0x811B, 0x811D, 0x811D, 0x811F, 0x811F,
+    0x8121, 0x8121, 0x8123, 0x8123, 0x8125, 0x8125, 0x8127, 0x8127,
+    0x8129, 0x8129, 0x812B, 0x812B, 0x812D, 0x812D, 0x812F, 0x812F,
+    0x8130, 0x8131, 0x8133, 0x8133, 0x8135, 0x8135, 0x8137, 0x8137,
+    0x8138, 0x813A, 0x813A, 0x813C, 0x813C, 0x813E, 0x813E, 0x8140,
+    0x8140, 0x8142, 0x8142, 0x8144, 0x8144, 0x8146, 0x8146, 0x8148,
+    0x8148, 0x8149, 0x814B, 0x814B, 0x814D, 0x814D, 0x814F, 0x814F,
+    0x8151, 0x8151, 0x8153, 0x8153, 0x8155, 0x8155, 0x8157, 0x8157,
+    0x8159, 0x8159, 0x815B, 0x815B, 0x815D, 0x815D, 0x815F, 0x815F,
+    0x8161, 0x8161, 0x8163, 0x8163, 0x8165, 0x8165, 0x8167, 0x8167,
+    0x8169, 0x8169, 0x816B, 0x816B, 0x816D, 0x816D, 0x816F, 0x816F,
+    0x8171, 0x8171, 0x8173, 0x8173, 0x8175, 0x8175, 0x8177, 0x8177,
+    0x80FF, 0x817A, 0x817A, 0x817C, 0x817C, 0x817E, 0x817E, 0x817F,
+    0x8180, 0x8253, 0x8183, 0x8183, 0x8185, 0x8185, 0x8254, 0x8188,
+    0x8188, 0x8256, 0x8257, 0x818C, 0x818C, 0x818D, 0x81DD, 0x8259,
+    0x825B, 0x8192, 0x8192, 0x8260, 0x8263, 0x8195, 0x8269, 0x8268,
+    0x8199, 0x8199, 0x819A, 0x819B, 0x826F, 0x8272, 0x819E, 0x8275,
+    0x81A1, 0x81A1, 0x81A3, 0x81A3, 0x81A5, 0x81A5, 0x8280, 0x81A8,
+    0x81A8, 0x8283, 0x81AA, 0x81AB, 0x81AD, 0x81AD, 0x8288, 0x81B0,
+    0x81B0, 0x828A, 0x828B, 0x81B4, 0x81B4, 0x81B6, 0x81B6, 0x8292,
+    0x81B9, 0x81B9, 0x81BA, 0x81BB, 0x81BD, 0x81BD, 0x81BE, 0x81BF,
+    0x81C0, 0x81C1, 0x81C2, 0x81C3, 0x81C6, 0x81C6, 0x81C6, 0x81C9,
+    0x81C9, 0x81C9, 0x81CC, 0x81CC, 0x81CC, 0x81CE, 0x81CE, 0x81D0,
+    0x81D0, 0x81D2, 0x81D2, 0x81D4, 0x81D4, 0x81D6, 0x81D6, 0x81D8,
+    0x81D8, 0x81DA, 0x81DA, 0x81DC, 0x81DC, 0x81DD, 0x81DF, 0x81DF,
+    0x81E1, 0x81E1, 0x81E3, 0x81E3, 0x81E5, 0x81E5, 0x81E7, 0x81E7,
+    0x81E9, 0x81E9, 0x81EB, 0x81EB, 0x81ED, 0x81ED, 0x81EF, 0x81EF,
+    0x81F0, 0x81F3, 0x81F3, 0x81F3, 0x81F5, 0x81F5, 0x8195, 0x81BF,
+    0x81F9, 0x81F9, 0x81FB, 0x81FB, 0x81FD, 0x81FD, 0x81FF, 0x81FF,
+    0x8201, 0x8201, 0x8203, 0x8203, 0x8205, 0x8205, 0x8207, 0x8207,
+    0x8209, 0x8209, 0x820B, 0x820B, 0x820D, 0x820D, 0x820F, 0x820F,
+    0x8211, 0x8211, 0x8213, 0x8213, 0x8215, 0x8215, 0x8217, 0x8217,
+    0x8219, 0x8219, 0x821B, 0x821B, 0x821D, 0x821D, 0x821F, 0x821F,
+    0x819E, 0x8221, 0x8223, 0x8223, 0x8225, 0x8225, 0x8227, 0x8227,
+    0x8229, 0x8229, 0x822B, 0x822B, 0x822D, 0x822D, 0x822F, 0x822F,
+    0x8231, 0x8231, 0x8233, 0x8233, 0x8234, 0x8235, 0x8236, 0x8237,
+    0x8238, 0x8239, 0x823A, 0x823C, 0x823C, 0x819A, 0x823E, 0x823F,
+    0x8240, 0x8242, 0x8242, 0x8180, 0x8289, 0x828C, 0x8247, 0x8247,
+    0x8249, 0x8249, 0x824B, 0x824B, 0x824D, 0x824D, 0x824F, 0x824F,
+    0x8250, 0x8251, 0x8252, 0x8253, 0x8254, 0x8255, 0x8256, 0x8257,
+    0x8258, 0x8259, 0x825A, 0x825B, 0x825C, 0x825D, 0x825E, 0x825F,
+    0x8260, 0x8261, 0x8262, 0x8263, 0x8264, 0x8265, 0x8266, 0x8267,
+    0x8268, 0x8269, 0x826A, 0x826B, 0x826C, 0x826D, 0x826E, 0x826F,
+    0x8270, 0x8271, 0x8272, 0x8273, 0x8274, 0x8275, 0x8276, 0x8277,
+    0x8278, 0x8279, 0x827A, 0x827B, 0x827C, 0x827D, 0x827E, 0x827F,
+    0x8280, 0x8281, 0x8282, 0x8283, 0x8284, 0x8285, 0x8286, 0x8287,
+    0x8288, 0x8289, 0x828A, 0x828B, 0x828C, 0x828D, 0x828E, 0x828F,
+    0x8290, 0x8291, 0x8292, 0x8293, 0x8294, 0x8295, 0x8296, 0x8297,
+    0x8298, 0x8299, 0x829A, 0x829B, 0x829C, 0x829D, 0x829E, 0x829F,
+    0x82A0, 0x82A1, 0x82A2, 0x82A3, 0x82A4, 0x82A5, 0x82A6, 0x82A7,
+    0x82A8, 0x82A9, 0x82AA, 0x82AB, 0x82AC, 0x82AD, 0x82AE, 0x82AF,
+    0x82B0, 0x82B1, 0x82B2, 0x82B3, 0x82B4, 0x82B5, 0x82B6, 0x82B7,
+    0x82B8, 0x82B9, 0x82BA, 0x82BB, 0x82BC, 0x82BD, 0x82BE, 0x82BF,
+    0x82C0, 0x82C1, 0x02C2, 0x02C3, 0x02C4, 0x02C5, 0x82C6, 0x82C7,
+    0x82C8, 0x82C9, 0x82CA, 0x82CB, 0x82CC, 0x82CD, 0x82CE, 0x82CF,
+    0x82D0, 0x82D1, 0x02D2, 0x02D3, 0x02D4, 0x02D5, 0x02D6, 0x02D7,
+    0x02D8, 0x02D9, 0x02DA, 0x02DB, 0x02DC, 0x02DD, 0x02DE, 0x02DF,
+    0x82E0, 0x82E1, 0x82E2, 0x82E3, 0x82E4, 0x02E5, 0x02E6, 0x02E7,
+    0x02E8, 0x02E9, 0x02EA, 0x02EB, 0x82EC, 0x02ED, 0x82EE, 0x02EF,
+    0x02F0, 0x02F1, 0x02F2, 0x02F3, 0x02F4, 0x02F5, 0x02F6, 0x02F7,
+    0x02F8, 0x02F9, 0x02FA, 0x02FB, 0x02FC, 0x02FD, 0x02FE, 0x02FF,
+    0x8300, 0x8301, 0x8302, 0x8303, 0x8304, 0x8305, 0x8306, 0x8307,
+    0x8308, 0x8309, 0x830A, 0x830B, 0x830C, 0x830D, 0x830E, 0x830F,
+    0x8310, 0x8311, 0x8312, 0x8313, 0x8314, 0x8315, 0x8316, 0x8317,
+    0x8318, 0x8319, 0x831A, 0x831B, 0x831C, 0x831D, 0x831E, 0x831F,
+    0x8320, 0x8321, 0x8322, 0x8323, 0x8324, 0x8325, 0x8326, 0x8327,
+    0x8328, 0x8329, 0x832A, 0x832B, 0x832C, 0x832D, 0x832E, 0x832F,
+    0x8330, 0x8331, 0x8332, 0x8333, 0x8334, 0x8335, 0x8336, 0x8337,
+    0x8338, 0x8339, 0x833A, 0x833B, 0x833C, 0x833D, 0x833E, 0x833F,
+    0x8340, 0x8341, 0x8342, 0x8343, 0x8344, 0x83B9, 0x8346, 0x8347,
+    0x8348, 0x8349, 0x834A, 0x834B, 0x834C, 0x834D, 0x834E, 0x834F,
+    0x8350, 0x8351, 0x8352, 0x8353, 0x8354, 0x8355, 0x8356, 0x8357,
+    0x8358, 0x8359, 0x835A, 0x835B, 0x835C, 0x835D, 0x835E, 0x835F,
+    0x8360, 0x8361, 0x8362, 0x8363, 0x8364, 0x8365, 0x8366, 0x8367,
+    0x8368, 0x8369, 0x836A, 0x836B, 0x836C, 0x836D, 0x836E, 0x836F,
+    0x8371, 0x8371, 0x8373, 0x8373, 0x8374, 0x0375, 0x8377, 0x8377,
+    0x0378, 0x0379, 0x837A, 0x837B, 0x837C, 0x837D, 0x037E, 0x83F3,
+    0x0380, 0x0381, 0x0382, 0x0383, 0x0384, 0x0385, 0x83AC, 0x0387,
+    0x83AD, 0x83AE, 0x83AF, 0x038B, 0x83CC, 0x038D, 0x83CD, 0x83CE,
+    0x8390, 0x83B1, 0x83B2, 0x83B3, 0x83B4, 0x83B5, 0x83B6, 0x83B7,
+    0x83B8, 0x83B9, 0x83BA, 0x83BB, 0x83BC, 0x83BD, 0x83BE, 0x83BF,
+    0x83C0, 0x83C1, 0x03A2, 0x83C3, 0x83C4, 0x83C5, 0x83C6, 0x83C7,
+    0x83C8, 0x83C9, 0x83CA, 0x83CB, 0x83AC, 0x83AD, 0x83AE, 0x83AF,
+    0x83B0, 0x83B1, 0x83B2, 0x83B3, 0x83B4, 0x83B5, 0x83B6, 0x83B7,
+    0x83B8, 0x83B9, 0x83BA, 0x83BB, 0x83BC, 0x83BD, 0x83BE, 0x83BF,
+    0x83C0, 0x83C1, 0x83C3, 0x83C3, 0x83C4, 0x83C5, 0x83C6, 0x83C7,
+    0x83C8, 0x83C9, 0x83CA, 0x83CB, 0x83CC, 0x83CD, 0x83CE, 0x83D7,
+    0x83B2, 0x83B8, 0x83D2, 0x83D3, 0x83D4, 0x83C6, 0x83C0, 0x83D7,
+    0x83D9, 0x83D9, 0x83DB, 0x83DB, 0x83DD, 0x83DD, 0x83DF, 0x83DF,
+    0x83E1, 0x83E1, 0x83E3, 0x83E3, 0x83E5, 0x83E5, 0x83E7, 0x83E7,
+    0x83E9, 0x83E9, 0x83EB, 0x83EB, 0x83ED, 0x83ED, 0x83EF, 0x83EF,
+    0x83BA, 0x83C1, 0x83F2, 0x83F3, 0x83B8, 0x83B5, 0x03F6, 0x83F8,
+    0x83F8, 0x83F2, 0x83FB, 0x83FB, 0x83FC, 0x837B, 0x837C, 0x837D,
+    0x8450, 0x8451, 0x8452, 0x8453, 0x8454, 0x8455, 0x8456, 0x8457,
+    0x8458, 0x8459, 0x845A, 0x845B, 0x845C, 0x845D, 0x845E, 0x845F,
+    0x8430, 0x8431, 0x8432, 0x8433, 0x8434, 0x8435, 0x8436, 0x8437,
+    0x8438, 0x8439, 0x843A, 0x843B, 0x843C, 0x843D, 0x843E, 0x843F,
+    0x8440, 0x8441, 0x8442, 0x8443, 0x8444, 0x8445, 0x8446, 0x8447,
+    0x8448, 0x8449, 0x844A, 0x844B, 0x844C, 0x844D, 0x844E, 0x844F,
+    0x8430, 0x8431, 0x8432, 0x8433, 0x8434, 0x8435, 0x8436, 0x8437,
+    0x8438, 0x8439, 0x843A, 0x843B, 0x843C, 0x843D, 0x843E, 0x843F,
+    0x8440, 0x8441, 0x8442, 0x8443, 0x8444, 0x8445, 0x8446, 0x8447,
+    0x8448, 0x8449, 0x844A, 0x844B, 0x844C, 0x844D, 0x844E, 0x844F,
+    0x8450, 0x8451, 0x8452, 0x8453, 0x8454, 0x8455, 0x8456, 0x8457,
+    0x8458, 0x8459, 0x845A, 0x845B, 0x845C, 0x845D, 0x845E, 0x845F,
+    0x8461, 0x8461, 0x8463, 0x8463, 0x8465, 0x8465, 0x8467, 0x8467,
+    0x8469, 0x8469, 0x846B, 0x846B, 0x846D, 0x846D, 0x846F, 0x846F,
+    0x8471, 0x8471, 0x8473, 0x8473, 0x8475, 0x8475, 0x8477, 0x8477,
+    0x8479, 0x8479, 0x847B, 0x847B, 0x847D, 0x847D, 0x847F, 0x847F,
+    0x8481, 0x8481, 0x0482, 0x8483, 0x8484, 0x8485, 0x8486, 0x8487,
+    0x0488, 0x0489, 0x848B, 0x848B, 0x848D, 0x848D, 0x848F, 0x848F,
+    0x8491, 0x8491, 0x8493, 0x8493, 0x8495, 0x8495, 0x8497, 0x8497,
+    0x8499, 0x8499, 0x849B, 0x849B, 0x849D, 0x849D, 0x849F, 0x849F,
+    0x84A1, 0x84A1, 0x84A3, 0x84A3, 0x84A5, 0x84A5, 0x84A7, 0x84A7,
+    0x84A9, 0x84A9, 0x84AB, 0x84AB, 0x84AD, 0x84AD, 0x84AF, 0x84AF,
+    0x84B1, 0x84B1, 0x84B3, 0x84B3, 0x84B5, 0x84B5, 0x84B7, 0x84B7,
+    0x84B9, 0x84B9, 0x84BB, 0x84BB, 0x84BD, 0x84BD, 0x84BF, 0x84BF,
+    0x84CF, 0x84C2, 0x84C2, 0x84C4, 0x84C4, 0x84C6, 0x84C6, 0x84C8,
+    0x84C8, 0x84CA, 0x84CA, 0x84CC, 0x84CC, 0x84CE, 0x84CE, 0x84CF,
+    0x84D1, 0x84D1, 0x84D3, 0x84D3, 0x84D5, 0x84D5, 0x84D7, 0x84D7,
+    0x84D9, 0x84D9, 0x84DB, 0x84DB, 0x84DD, 0x84DD, 0x84DF, 0x84DF,
+    0x84E1, 0x84E1, 0x84E3, 0x84E3, 0x84E5, 0x84E5, 0x84E7, 0x84E7,
+    0x84E9, 0x84E9, 0x84EB, 0x84EB, 0x84ED, 0x84ED, 0x84EF, 0x84EF,
+    0x84F1, 0x84F1, 0x84F3, 0x84F3, 0x84F5, 0x84F5, 0x84F7, 0x84F7,
+    0x84F9, 0x84F9, 0x84FB, 0x84FB, 0x84FD, 0x84FD, 0x84FF, 0x84FF,
+    0x8501, 0x8501, 0x8503, 0x8503, 0x8505, 0x8505, 0x8507, 0x8507,
+    0x8509, 0x8509, 0x850B, 0x850B, 0x850D, 0x850D, 0x850F, 0x850F,
+    0x8511, 0x8511, 0x8513, 0x8513, 0x8515, 0x8515, 0x8517, 0x8517,
+    0x8519, 0x8519, 0x851B, 0x851B, 0x851D, 0x851D, 0x851F, 0x851F,
+    0x8521, 0x8521, 0x8523, 0x8523, 0x8525, 0x8525, 0x8527, 0x8527,
+    0x8529, 0x8529, 0x852B, 0x852B, 0x852D, 0x852D, 0x852F, 0x852F,
+    0x0530, 0x8561, 0x8562, 0x8563, 0x8564, 0x8565, 0x8566, 0x8567,
+    0x8568, 0x8569, 0x856A, 0x856B, 0x856C, 0x856D, 0x856E, 0x856F,
+    0x8570, 0x8571, 0x8572, 0x8573, 0x8574, 0x8575, 0x8576, 0x8577,
+    0x8578, 0x8579, 0x857A, 0x857B, 0x857C, 0x857D, 0x857E, 0x857F,
+    0x8580, 0x8581, 0x8582, 0x8583, 0x8584, 0x8585, 0x8586, 0x0557,
+    0x0558, 0x8559, 0x055A, 0x055B, 0x055C, 0x055D, 0x055E, 0x055F,
+    0x8560, 0x8561, 0x8562, 0x8563, 0x8564, 0x8565, 0x8566, 0x8567,
+    0x8568, 0x8569, 0x856A, 0x856B, 0x856C, 0x856D, 0x856E, 0x856F,
+    0x8570, 0x8571, 0x8572, 0x8573, 0x8574, 0x8575, 0x8576, 0x8577,
+    0x8578, 0x8579, 0x857A, 0x857B, 0x857C, 0x857D, 0x857E, 0x857F,
+    0x8580, 0x8581, 0x8582, 0x8583, 0x8584, 0x8585, 0x8586, 0x8587,
+    0x8588, 0x0589, 0x058A, 0x058B, 0x058C, 0x058D, 0x058E, 0x058F,
+    0x0590, 0x8591, 0x8592, 0x8593, 0x8594, 0x8595, 0x8596, 0x8597,
+    0x8598, 0x8599, 0x859A, 0x859B, 0x859C, 0x859D, 0x859E, 0x859F,
+    0x85A0, 0x85A1, 0x85A2, 0x85A3, 0x85A4, 0x85A5, 0x85A6, 0x85A7,
+    0x85A8, 0x85A9, 0x85AA, 0x85AB, 0x85AC, 0x85AD, 0x85AE, 0x85AF,
+    0x85B0, 0x85B1, 0x85B2, 0x85B3, 0x85B4, 0x85B5, 0x85B6, 0x85B7,
+    0x85B8, 0x85B9, 0x85BA, 0x85BB, 0x85BC, 0x85BD, 0x05BE, 0x85BF,
+    0x05C0, 0x85C1, 0x85C2, 0x05C3, 0x85C4, 0x85C5, 0x05C6, 0x85C7,
+    0x05C8, 0x05C9, 0x05CA, 0x05CB, 0x05CC, 0x05CD, 0x05CE, 0x05CF,
+    0x85D0, 0x85D1, 0x85D2, 0x85D3, 0x85D4, 0x85D5, 0x85D6, 0x85D7,
+    0x85D8, 0x85D9, 0x85DA, 0x85DB, 0x85DC, 0x85DD, 0x85DE, 0x85DF,
+    0x85E0, 0x85E1, 0x85E2, 0x85E3, 0x85E4, 0x85E5, 0x85E6, 0x85E7,
+    0x85E8, 0x85E9, 0x85EA, 0x05EB, 0x05EC, 0x05ED, 0x05EE, 0x85EF,
+    0x85F0, 0x85F1, 0x85F2, 0x05F3, 0x05F4, 0x05F5, 0x05F6, 0x05F7,
+    0x05F8, 0x05F9, 0x05FA, 0x05FB, 0x05FC, 0x05FD, 0x05FE, 0x05FF,
+    0x0600, 0x0601, 0x0602, 0x0603, 0x0604, 0x0605, 0x0606, 0x0607,
+    0x0608, 0x0609, 0x060A, 0x060B, 0x060C, 0x060D, 0x060E, 0x060F,
+    0x8610, 0x8611, 0x8612, 0x8613, 0x8614, 0x8615, 0x8616, 0x8617,
+    0x8618, 0x8619, 0x861A, 0x061B, 0x061C, 0x061D, 0x061E, 0x061F,
+    0x8620, 0x8621, 0x8622, 0x8623, 0x8624, 0x8625, 0x8626, 0x8627,
+    0x8628, 0x8629, 0x862A, 0x862B, 0x862C, 0x862D, 0x862E, 0x862F,
+    0x8630, 0x8631, 0x8632, 0x8633, 0x8634, 0x8635, 0x8636, 0x8637,
+    0x8638, 0x8639, 0x863A, 0x863B, 0x863C, 0x863D, 0x863E, 0x863F,
+    0x8640, 0x8641, 0x8642, 0x8643, 0x8644, 0x8645, 0x8646, 0x8647,
+    0x8648, 0x8649, 0x864A, 0x864B, 0x864C, 0x864D, 0x864E, 0x864F,
+    0x8650, 0x8651, 0x8652, 0x8653, 0x8654, 0x8655, 0x8656, 0x8657,
+    0x8658, 0x8659, 0x865A, 0x865B, 0x865C, 0x865D, 0x865E, 0x865F,
+    0x0660, 0x0661, 0x0662, 0x0663, 0x0664, 0x0665, 0x0666, 0x0667,
+    0x0668, 0x0669, 0x066A, 0x066B, 0x066C, 0x066D, 0x866E, 0x866F,
+    0x8670, 0x8671, 0x8672, 0x8673, 0x8674, 0x8675, 0x8676, 0x8677,
+    0x8678, 0x8679, 0x867A, 0x867B, 0x867C, 0x867D, 0x867E, 0x867F,
+    0x8680, 0x8681, 0x8682, 0x8683, 0x8684, 0x8685, 0x8686, 0x8687,
+    0x8688, 0x8689, 0x868A, 0x868B, 0x868C, 0x868D, 0x868E, 0x868F,
+    0x8690, 0x8691, 0x8692, 0x8693, 0x8694, 0x8695, 0x8696, 0x8697,
+    0x8698, 0x8699, 0x869A, 0x869B, 0x869C, 0x869D, 0x869E, 0x869F,
+    0x86A0, 0x86A1, 0x86A2, 0x86A3, 0x86A4, 0x86A5, 0x86A6, 0x86A7,
+    0x86A8, 0x86A9, 0x86AA, 0x86AB, 0x86AC, 0x86AD, 0x86AE, 0x86AF,
+    0x86B0, 0x86B1, 0x86B2, 0x86B3, 0x86B4, 0x86B5, 0x86B6, 0x86B7,
+    0x86B8, 0x86B9, 0x86BA, 0x86BB, 0x86BC, 0x86BD, 0x86BE, 0x86BF,
+    0x86C0, 0x86C1, 0x86C2, 0x86C3, 0x86C4, 0x86C5, 0x86C6, 0x86C7,
+    0x86C8, 0x86C9, 0x86CA, 0x86CB, 0x86CC, 0x86CD, 0x86CE, 0x86CF,
+    0x86D0, 0x86D1, 0x86D2, 0x86D3, 0x06D4, 0x86D5, 0x86D6, 0x86D7,
+    0x86D8, 0x86D9, 0x86DA, 0x86DB, 0x86DC, 0x06DD, 0x06DE, 0x86DF,
+    0x86E0, 0x86E1, 0x86E2, 0x86E3, 0x86E4, 0x86E5, 0x86E6, 0x86E7,
+    0x86E8, 0x06E9, 0x86EA, 0x86EB, 0x86EC, 0x86ED, 0x86EE, 0x86EF,
+    0x06F0, 0x06F1, 0x06F2, 0x06F3, 0x06F4, 0x06F5, 0x06F6, 0x06F7,
+    0x06F8, 0x06F9, 0x86FA, 0x86FB, 0x86FC, 0x06FD, 0x06FE, 0x86FF,
+    0x0700, 0x0701, 0x0702, 0x0703, 0x0704, 0x0705, 0x0706, 0x0707,
+    0x0708, 0x0709, 0x070A, 0x070B, 0x070C, 0x070D, 0x070E, 0x070F,
+    0x8710, 0x8711, 0x8712, 0x8713, 0x8714, 0x8715, 0x8716, 0x8717,
+    0x8718, 0x8719, 0x871A, 0x871B, 0x871C, 0x871D, 0x871E, 0x871F,
+    0x8720, 0x8721, 0x8722, 0x8723, 0x8724, 0x8725, 0x8726, 0x8727,
+    0x8728, 0x8729, 0x872A, 0x872B, 0x872C, 0x872D, 0x872E, 0x872F,
+    0x8730, 0x8731, 0x8732, 0x8733, 0x8734, 0x8735, 0x8736, 0x8737,
+    0x8738, 0x8739, 0x873A, 0x873B, 0x873C, 0x873D, 0x873E, 0x873F,
+    0x8740, 0x8741, 0x8742, 0x8743, 0x8744, 0x8745, 0x8746, 0x8747,
+    0x8748, 0x8749, 0x874A, 0x074B, 0x074C, 0x874D, 0x874E, 0x874F,
+    0x8750, 0x8751, 0x8752, 0x8753, 0x8754, 0x8755, 0x8756, 0x8757,
+    0x8758, 0x8759, 0x875A, 0x875B, 0x875C, 0x875D, 0x875E, 0x875F,
+    0x8760, 0x8761, 0x8762, 0x8763, 0x8764, 0x8765, 0x8766, 0x8767,
+    0x8768, 0x8769, 0x876A, 0x876B, 0x876C, 0x876D, 0x876E, 0x876F,
+    0x8770, 0x8771, 0x8772, 0x8773, 0x8774, 0x8775, 0x8776, 0x8777,
+    0x8778, 0x8779, 0x877A, 0x877B, 0x877C, 0x877D, 0x877E, 0x877F,
+    0x8780, 0x8781, 0x8782, 0x8783, 0x8784, 0x8785, 0x8786, 0x8787,
+    0x8788, 0x8789, 0x878A, 0x878B, 0x878C, 0x878D, 0x878E, 0x878F,
+    0x8790, 0x8791, 0x8792, 0x8793, 0x8794, 0x8795, 0x8796, 0x8797,
+    0x8798, 0x8799, 0x879A, 0x879B, 0x879C, 0x879D, 0x879E, 0x879F,
+    0x87A0, 0x87A1, 0x87A2, 0x87A3, 0x87A4, 0x87A5, 0x87A6, 0x87A7,
+    0x87A8, 0x87A9, 0x87AA, 0x87AB, 0x87AC, 0x87AD, 0x87AE, 0x87AF,
+    0x87B0, 0x87B1, 0x07B2, 0x07B3, 0x07B4, 0x07B5, 0x07B6, 0x07B7,
+    0x07B8, 0x07B9, 0x07BA, 0x07BB, 0x07BC, 0x07BD, 0x07BE, 0x07BF,
+    0x07C0, 0x07C1, 0x07C2, 0x07C3, 0x07C4, 0x07C5, 0x07C6, 0x07C7,
+    0x07C8, 0x07C9, 0x87CA, 0x87CB, 0x87CC, 0x87CD, 0x87CE, 0x87CF,
+    0x87D0, 0x87D1, 0x87D2, 0x87D3, 0x87D4, 0x87D5, 0x87D6, 0x87D7,
+    0x87D8, 0x87D9, 0x87DA, 0x87DB, 0x87DC, 0x87DD, 0x87DE, 0x87DF,
+    0x87E0, 0x87E1, 0x87E2, 0x87E3, 0x87E4, 0x87E5, 0x87E6, 0x87E7,
+    0x87E8, 0x87E9, 0x87EA, 0x87EB, 0x87EC, 0x87ED, 0x87EE, 0x87EF,
+    0x87F0, 0x87F1, 0x87F2, 0x87F3, 0x87F4, 0x87F5, 0x07F6, 0x07F7,
+    0x07F8, 0x07F9, 0x87FA, 0x07FB, 0x07FC, 0x87FD, 0x07FE, 0x07FF,
+};
+
+/* Every stride-th code point from first to last folds to itself + delta */
+static const t4_utf8_fold_t t4_utf8_folds[169] = {
+    { 0x000B5, 0x000B5,    775, 1 },
+    { 0x000C0, 0x000D6,     32, 1 },
+    { 0x000D8, 0x000DE,     32, 1 },
+    { 0x00100, 0x0012E,      1, 2 },
+    { 0x00132, 0x00136,      1, 2 },
+    { 0x00139, 0x00147,      1, 2 },
+    { 0x0014A, 0x00176,      1, 2 },
+    { 0x00178, 0x00178,   -121, 1 },
+    { 0x00179, 0x0017D,      1, 2 },
+    { 0x00181, 0x00181,    210, 1 },
+    { 0x00182, 0x00184,      1, 2 },
+    { 0x00186, 0x00186,    206, 1 },
+    { 0x00187, 0x00187,      1, 1 },
+    { 0x00189, 0x0018A,    205, 1 },
+    { 0x0018B, 0x0018B,      1, 1 },
+    { 0x0018E, 0x0018E,     79, 1 },
+    { 0x0018F, 0x0018F,    202, 1 },
+    { 0x00190, 0x00190,    203, 1 },
+    { 0x00191, 0x00191,      1, 1 },
+    { 0x00193, 0x00193,    205, 1 },
+    { 0x00194, 0x00194,    207, 1 },
+    { 0x00196, 0x00196,    211, 1 },
+    { 0x00197, 0x00197,    209, 1 },
+    { 0x00198, 0x00198,      1, 1 },
+    { 0x0019C, 0x0019C,    211, 1 },
+    { 0x0019D, 0x0019D,    213, 1 },
+    { 0x0019F, 0x0019F,    214, 1 },
+    { 0x001A0, 0x001A4,      1, 2 },
+    { 0x001A6, 0x001A6,    218, 1 },
+    { 0x001A7, 0x001A7,      1, 1 },
+    { 0x001A9, 0x001A9,    218, 1 },
+    { 0x001AC, 0x001AC,      1, 1 },
+    { 0x001AE, 0x001AE,    218, 1 },
+    { 0x001AF, 0x001AF,      1, 1 },
+    { 0x001B1, 0x001B2,    217, 1 },
+    { 0x001B3, 0x001B5,      1, 2 },
+    { 0x001B7, 0x001B7,    219, 1 },
+    { 0x001B8, 0x001B8,      1, 1 },
+    { 0x001BC, 0x001BC,      1, 1 },
+    { 0x001C4, 0x001C4,      2, 1 },
+    { 0x001C5, 0x001C5,      1, 1 },
+    { 0x001C7, 0x001C7,      2, 1 },
+    { 0x001C8, 0x001C8,      1, 1 },
+    { 0x001CA, 0x001CA,      2, 1 },
+    { 0x001CB, 0x001DB,      1, 2 },
+    { 0x001DE, 0x001EE,      1, 2 },
+    { 0x001F1, 0x001F1,      2, 1 },
+    { 0x001F2, 0x001F4,      1, 2 },
+    { 0x001F6, 0x001F6,    -97, 1 },
+    { 0x001F7, 0x001F7,    -56, 1 },
+    { 0x001F8, 0x0021E,      1, 2 },
+    { 0x00220, 0x00220,   -130, 1 },
+    { 0x00222, 0x00232,      1, 2 },
+    { 0x0023B, 0x0023B,      1, 1 },
+    { 0x0023D, 0x0023D,   -163, 1 },
+    { 0x00241, 0x00241,      1, 1 },
+    { 0x00243, 0x00243,   -195, 1 },
+    { 0x00244, 0x00244,     69, 1 },
+    { 0x00245, 0x00245,     71, 1 },
+    { 0x00246, 0x0024E,      1, 2 },
+    { 0x00345, 0x00345,    116, 1 },
+    { 0x00370, 0x00372,      1, 2 },
+    { 0x00376, 0x00376,      1, 1 },
+    { 0x0037F, 0x0037F,    116, 1 },
+    { 0x00386, 0x00386,     38, 1 },
+    { 0x00388, 0x0038A,     37, 1 },
+    { 0x0038C, 0x0038C,     64, 1 },
+    { 0x0038E, 0x0038F,     63, 1 },
+    { 0x00391, 0x003A1,     32, 1 },
+    { 0x003A3, 0x003AB,     32, 1 },
+    { 0x003C2, 0x003C2,      1, 1 },
+    { 0x003CF, 0x003CF,      8, 1 },
+    { 0x003D0, 0x003D0,    -30, 1 },
+    { 0x003D1, 0x003D1,    -25, 1 },
+    { 0x003D5, 0x003D5,    -15, 1 },
+    { 0x003D6, 0x003D6,    -22, 1 },
+    { 0x003D8, 0x003EE,      1, 2 },
+    { 0x003F0, 0x003F0,    -54, 1 },
+    { 0x003F1, 0x003F1,    -48, 1 },
+    { 0x003F4, 0x003F4,    -60, 1 },
+    { 0x003F5, 0x003F5,    -64, 1 },
+    { 0x003F7, 0x003F7,      1, 1 },
+    { 0x003F9, 0x003F9,     -7, 1 },
+    { 0x003FA, 0x003FA,      1, 1 },
+    { 0x003FD, 0x003FF,   -130, 1 },
+    { 0x00400, 0x0040F,     80, 1 },
+    { 0x00410, 0x0042F,     32, 1 },
+    { 0x00460, 0x00480,      1, 2 },
+    { 0x0048A, 0x004BE,      1, 2 },
+    { 0x004C0, 0x004C0,     15, 1 },
+    { 0x004C1, 0x004CD,      1, 2 },
+    { 0x004D0, 0x0052E,      1, 2 },
+    { 0x00531, 0x00556,     48, 1 },
+    { 0x010A0, 0x010C5,   7264, 1 },
+    { 0x010C7, 0x010C7,   7264, 1 },
+    { 0x010CD, 0x010CD,   7264, 1 },
+    { 0x013F8, 0x013FD,     -8, 1 },
+    { 0x01C88, 0x01C88,  35267, 1 },
+    { 0x01C90, 0x01CBA,  -3008, 1 },
+    { 0x01CBD, 0x01CBF,  -3008, 1 },
+    { 0x01E00, 0x01E94,      1, 2 },
+    { 0x01E9B, 0x01E9B,    -58, 1 },
+    { 0x01EA0, 0x01EFE,      1, 2 },
+    { 0x01F08, 0x01F0F,     -8, 1 },
+    { 0x01F18, 0x01F1D,     -8, 1 },
+    { 0x01F28, 0x01F2F,     -8, 1 },
+    { 0x01F38, 0x01F3F,     -8, 1 },
+    { 0x01F48, 0x01F4D,     -8, 1 },
+    { 0x01F59, 0x01F5F,     -8, 2 },
+    { 0x01F68, 0x01F6F,     -8, 1 },
+    { 0x01F88, 0x01F8F,     -8, 1 },
+    { 0x01F98, 0x01F9F,     -8, 1 },
+    { 0x01FA8, 0x01FAF,     -8, 1 },
+    { 0x01FB8, 0x01FB9,     -8, 1 },
+    { 0x01FBA, 0x01FBB,    -74, 1 },
+    { 0x01FBC, 0x01FBC,     -9, 1 },
+    { 0x01FC8, 0x01FCB,    -86, 1 },
+    { 0x01FCC, 0x01FCC,     -9, 1 },
+    { 0x01FD8, 0x01FD9,     -8, 1 },
+    { 0x01FDA, 0x01FDB,   -100, 1 },
+    { 0x01FE8, 0x01FE9,     -8, 1 },
+    { 0x01FEA, 0x01FEB,   -112, 1 },
+    { 0x01FEC, 0x01FEC,     -7, 1 },
+    { 0x01FF8, 0x01FF9,   -128, 1 },
+    { 0x01FFA, 0x01FFB,   -126, 1 },
+    { 0x01FFC, 0x01FFC,     -9, 1 },
+    { 0x02132, 0x02132,     28, 1 },
+    { 0x02160, 0x0216F,     16, 1 },
+    { 0x02183, 0x02183,      1, 1 },
+    { 0x024B6, 0x024CF,     26, 1 },
+    { 0x02C00, 0x02C2F,     48, 1 },
+    { 0x02C60, 0x02C60,      1, 1 },
+    { 0x02C63, 0x02C63,  -3814, 1 },
+    { 0x02C67, 0x02C6B,      1, 2 },
+    { 0x02C72, 0x02C72,      1, 1 },
+    { 0x02C75, 0x02C75,      1, 1 },
+    { 0x02C80, 0x02CE2,      1, 2 },
+    { 0x02CEB, 0x02CED,      1, 2 },
+    { 0x02CF2, 0x02CF2,      1, 1 },
+    { 0x0A640, 0x0A66C,      1, 2 },
+    { 0x0A680, 0x0A69A,      1, 2 },
+    { 0x0A722, 0x0A72E,      1, 2 },
+    { 0x0A732, 0x0A76E,      1, 2 },
+    { 0x0A779, 0x0A77B,      1, 2 },
+    { 0x0A77D, 0x0A77D, -35332, 1 },
+    { 0x0A77E, 0x0A786,      1, 2 },
+    { 0x0A78B, 0x0A78B,      1, 1 },
+    { 0x0A790, 0x0A792,      1, 2 },
+    { 0x0A796, 0x0A7A8,      1, 2 },
+    { 0x0A7B3, 0x0A7B3,    928, 1 },
+    { 0x0A7B4, 0x0A7C2,      1, 2 },
+    { 0x0A7C4, 0x0A7C4,    -48, 1 },
+    { 0x0A7C6, 0x0A7C6, -35384, 1 },
+    { 0x0A7C7, 0x0A7C9,      1, 2 },
+    { 0x0A7D0, 0x0A7D0,      1, 1 },
+    { 0x0A7D6, 0x0A7D8,      1, 2 },
+    { 0x0A7F5, 0x0A7F5,      1, 1 },
+    { 0x0AB70, 0x0ABBF, -38864, 1 },
+    { 0x0FF21, 0x0FF3A,     32, 1 },
+    { 0x10400, 0x10427,     40, 1 },
+    { 0x104B0, 0x104D3,     40, 1 },
+    { 0x10570, 0x1057A,     39, 1 },
+    { 0x1057C, 0x1058A,     39, 1 },
+    { 0x1058C, 0x10592,     39, 1 },
+    { 0x10594, 0x10595,     39, 1 },
+    { 0x10C80, 0x10CB2,     64, 1 },
+    { 0x118A0, 0x118BF,     32, 1 },
+    { 0x16E40, 0x16E5F,     32, 1 },
+    { 0x1E900, 0x1E921,     34, 1 },
+};
+
+#endif /* T4_INTERNAL_UTF8_TABLES_H_ */
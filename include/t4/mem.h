@@ -23,21 +23,30 @@
 
 void * t4_calloc_debug(size_t n, size_t size, const char * file, int line);
 void * t4_calloc_aligned_debug(size_t size, size_t alignment, const char * file, int line);
+void * t4_realloc_debug(void * ptr, size_t n, size_t size, const char * file, int line);
 
 #define t4_calloc(n, size) t4_calloc_debug((n), (size), __FILE__, __LINE__)
 
 #define t4_calloc_aligned(size, alignment) \
     t4_calloc_aligned_debug((size), (alignment), __FILE__, __LINE__)
 
+/* Not zeroed past the old size, unlike t4_calloc */
+#define t4_realloc(ptr, n, size) t4_realloc_debug((ptr), (n), (size), __FILE__, __LINE__)
+
 #else
 
 // TODO
 // void * t4_calloc(size_t n, size_t size);
 // void * t4_calloc_aligned(size_t n, size_t size, size_t alignment);
+// void * t4_realloc(void * ptr, size_t n, size_t size);
 
 #endif /* !T4_DEBUG */
 
-#define T4_ALIGN_UP(expr, align) ((expr) + (align) - 1) & ~((align) - 1)
-#define T4_ALIGN_DOWN(expr, align) (expr) & ~((align) - 1)
+#define T4_ALIGN_UP(expr, align) (((expr) + (align) - 1) & ~((align) - 1))
+#define T4_ALIGN_DOWN(expr, align) ((expr) & ~((align) - 1))
+
+/* Smallest page size of anything we run on. Reading n bytes at ptr is safe, if ptr is, as long as this is false. */
+#define T4_PAGE_SIZE 4096
+#define T4_CROSSES_PAGE(ptr, n) (((uintptr_t)(ptr) & (T4_PAGE_SIZE - 1)) > T4_PAGE_SIZE - (n))
 
 #endif /* T4_MEM_H_ */
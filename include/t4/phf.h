@@ -0,0 +1,119 @@
+#ifndef T4_PHF_H_
+#define T4_PHF_H_
+
+#include "t4/common.h"
+#include "t4/stset.h"
+#include "t4/internal/ascii_fold.h"
+
+/**
+ * A minimal perfect hash over a fixed set of keys, for a dictionary that never changes: every key has a slot of its
+ * own among exactly as many slots as there are keys, so a lookup is one hash, one slot read and one compare, with
+ * no probing and nothing to tell apart by metadata.
+ *
+ * The function is PTHash-like: keys are hashed into buckets, skewed so 60% of them fall into 30% of the buckets,
+ * and every bucket has a pilot, picked at build time biggest bucket first, that sends all of its keys to slots no
+ * other key took. The build places them into a few percent more slots than keys and remaps the ones past the end
+ * into the holes left before it, which keeps pilots small; about 5 bits per key in all, on top of the keys.
+ *
+ * Everything lives in one flat image, made by t4_phf_build (t4_mkphf does it at build time for t4) and used in
+ * place, wherever it is: linked into the binary, mapped or read from a file. It is, with every part aligned to 8:
+ *  - a header: magic, format version, seed and sizes;
+ *  - the pilots, a u16 per bucket;
+ *  - the remap, a u32 per slot past the last key;
+ *  - the offsets, a u32 per key and one more, key i being the bytes from offsets[i] to offsets[i + 1];
+ *  - the keys, back to back in slot order.
+ *
+ * Keys are hashed with ASCII case folded, so one image answers both exact lookups and ones that ignore ASCII case
+ * (t4_phf_exists_folded, for words taken from a mapped input). Keys that only differ in ASCII case can therefore
+ * not be in the same image.
+ */
+typedef struct t4_phf {
+    u64 seed;
+    size_t num_keys;
+    size_t num_slots;
+    size_t num_buckets;
+    /* Buckets taking the dense 60% of the keys, the others come after them */
+    size_t num_dense_buckets;
+
+    const u16 * pilots;
+    const u32 * remap;
+    const u32 * offsets;
+    const u8 * keys;
+} t4_phf_t;
+
+/* Bumped whenever the image layout or the hash changes */
+#define T4_PHF_VERSION 2
+
+/**
+ * @brief Builds the image of a set of keys, which must all be distinct, even with ASCII case ignored.
+ *
+ * @param size Set to the size of the image
+ * @return The image, to be freed with t4_free, or NULL if the keys could not be placed (duplicates, or more than
+ *         2^32 - 1 keys or bytes of keys)
+ */
+extern u8 * t4_phf_build(const t4_stset_key_t * keys, size_t n, size_t * size);
+
+/**
+ * @brief Points self into an image made by @ref t4_phf_build; it must stay where it is as long as self is used,
+ * and be 8-byte aligned. Only the header is checked.
+ *
+ * @return false if it is not such an image, or one of another version
+ */
+extern bool t4_phf_open(t4_phf_t * self, const void * image, size_t size);
+
+/* Every key is hashed with ASCII case folded, and only that: distinct keys must not share a hash. */
+static inline u64 t4_phf_hash(const t4_phf_t * self, const void * data, const size_t size) {
+    return t4_wyhash_folded_exact(data, size, self->seed, _wyp);
+}
+
+/* The slot a pilot sends a key with this hash to, out of num_slots; the pilot is mixed in so every one differs. */
+static inline size_t t4_phf_position(const u64 hash, const u64 pilot, const size_t num_slots) {
+    const u64 mixed = _wymix(hash, _wymix(pilot ^ _wyp[0], _wyp[1]));
+
+    return (size_t)(((__uint128_t)mixed * num_slots) >> 64);
+}
+
+/* Low half of the hash picks dense or sparse, the high half the bucket within them. */
+static inline size_t t4_phf_bucket(const t4_phf_t * self, const u64 hash) {
+    const u64 high = hash >> 32;
+
+    /* 60% of 2^32 */
+    if ((u32)hash < 2576980378u) {
+        return (size_t)((high * self->num_dense_buckets) >> 32);
+    }
+
+    return self->num_dense_buckets + (size_t)((high * (self->num_buckets - self->num_dense_buckets)) >> 32);
+}
+
+/* The slot of a key that is in the set; any other key gets some slot too, only the compare tells them apart. */
+static inline size_t t4_phf_slot(const t4_phf_t * self, const u64 hash) {
+    const size_t pos = t4_phf_position(hash, self->pilots[t4_phf_bucket(self, hash)], self->num_slots);
+
+    return pos < self->num_keys ? pos : self->remap[pos - self->num_keys];
+}
+
+static T4_INLINE bool t4_phf_exists_impl(const t4_phf_t * self, const void * data, const size_t size, const bool fold) {
+    if (self->num_keys == 0) {
+        return false;
+    }
+
+    const size_t slot = t4_phf_slot(self, t4_phf_hash(self, data, size));
+    const u32 begin = self->offsets[slot];
+
+    if (self->offsets[slot + 1] - begin != size) {
+        return false;
+    }
+
+    return fold ? t4_ascii_eq_folded(self->keys + begin, data, size) : memcmp(self->keys + begin, data, size) == 0;
+}
+
+static inline bool t4_phf_exists(const t4_phf_t * self, const void * data, const size_t size) {
+    return t4_phf_exists_impl(self, data, size, false);
+}
+
+/* Same as @ref t4_phf_exists, but with ASCII case ignored, like a t4_stset with fold_case. */
+static inline bool t4_phf_exists_folded(const t4_phf_t * self, const void * data, const size_t size) {
+    return t4_phf_exists_impl(self, data, size, true);
+}
+
+#endif /* T4_PHF_H_ */
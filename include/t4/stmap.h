@@ -0,0 +1,80 @@
+#ifndef T4_STMAP_H_
+#define T4_STMAP_H_
+
+#include "t4/common.h"
+#include "t4/mem.h"
+#include "t4/stset.h"
+
+/**
+ * Maps keys to fixed size values. This is a t4_stset underneath, probed by the same backend, with the values kept
+ * in an array next to its entries: value i belongs to entry i, so they stay in insertion order too.
+ *
+ * Value pointers are only valid until the next insert, which may move the values.
+ */
+typedef struct t4_stmap {
+    t4_stset_t set;
+} t4_stmap_t;
+
+/**
+ * @param capacity Same as for @ref t4_stset_new
+ * @param value_size Bytes per value, eg. sizeof(u32) for counters; non-zero and a multiple of the value's alignment
+ * @return A map whose values all start out zeroed
+ */
+static inline t4_stmap_t t4_stmap_new(const size_t capacity, const size_t value_size) {
+    assert(value_size != 0);
+
+    t4_stset_t set = t4_stset_new(capacity);
+    set.value_size = value_size;
+    set.values = t4_calloc(set.entries_capacity, value_size);
+
+    return (t4_stmap_t) { .set = set, };
+}
+
+/* Same as @ref t4_stmap_new, but the keys are copied like in @ref t4_stset_new_owning */
+static inline t4_stmap_t t4_stmap_new_owning(const size_t capacity, const size_t value_size) {
+    t4_stmap_t map = t4_stmap_new(capacity, value_size);
+    map.set.owns_keys = true;
+    return map;
+}
+
+static inline void t4_stmap_free(t4_stmap_t * self) {
+    t4_stset_free(&self->set);
+}
+
+static inline size_t t4_stmap_size(const t4_stmap_t * self) {
+    return t4_stset_size(&self->set);
+}
+
+/**
+ * @brief Finds the value of a key, inserting the key with a zeroed value first if it is new, in a single probe;
+ * eg. counting a word is ++*(u32 *)t4_stmap_upsert(&map, word, size, NULL).
+ *
+ * @param inserted If not NULL, set to whether the key was new
+ */
+static inline void * t4_stmap_upsert(t4_stmap_t * self, void * data, const size_t data_size, bool * inserted) {
+    return t4_stset_map_upsert(&self->set, data, data_size, inserted);
+}
+
+/* @return The value of the key, or NULL if it is not in the map */
+static inline void * t4_stmap_get(const t4_stmap_t * self, const void * data, const size_t data_size) {
+    return t4_stset_map_get(&self->set, data, data_size);
+}
+
+static inline bool t4_stmap_remove(t4_stmap_t * self, const void * data, const size_t data_size) {
+    return t4_stset_remove(&self->set, data, data_size);
+}
+
+/**
+ * @brief Same as @ref t4_stset_next, also giving the value of the key.
+ */
+static inline const t4_stset_entry_t * t4_stmap_next(const t4_stmap_t * self, size_t * it, void ** value) {
+    const t4_stset_entry_t * e = t4_stset_next(&self->set, it);
+
+    if (e != NULL) {
+        *value = self->set.values + (*it - 1) * self->set.value_size;
+    }
+
+    return e;
+}
+
+#endif /* T4_STMAP_H_ */
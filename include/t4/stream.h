@@ -0,0 +1,67 @@
+#ifndef T4_STREAM_H_
+#define T4_STREAM_H_
+
+#include "t4/common.h"
+
+#include <stdio.h>
+#include <pthread.h>
+
+/* Bytes read at once. A run of more than this many bytes without an ASCII separator is cut, see t4_stream_next. */
+#define T4_STREAM_CHUNK (1u << 20)
+
+/**
+ * Reads a file, or a pipe, in fixed size chunks and hands them out cut at word boundaries, so each one can be
+ * tokenized on its own. A reader thread fills one of two buffers while the caller works on the other, and the
+ * partial word at the end of a chunk is carried over into the space kept free in front of the next one.
+ *
+ * Memory use is 4 * T4_STREAM_CHUNK no matter how large the input is; anything that has to outlive a chunk, eg.
+ * the keys of a set (see @ref t4_stset_new_owning), has to be copied out of it.
+ */
+typedef struct t4_stream {
+    FILE * file;
+    /* T4_STREAM_CHUNK bytes of room for the carried over bytes, then T4_STREAM_CHUNK for the chunk itself */
+    char * bufs[2];
+    size_t filled[2];
+    bool ready[2];
+    bool last[2];
+
+    /* Buffer handed out by the last t4_stream_next, and where its unprocessed tail starts */
+    size_t current;
+    char * tail;
+    size_t tail_size;
+    bool done;
+
+    bool failed;
+    bool closing;
+
+    pthread_t reader;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} t4_stream_t;
+
+/**
+ * @brief Starts reading file on a thread of its own. The stream must stay where it is until t4_stream_close.
+ *
+ * @return false, with errno set, if the thread could not be started; the stream is then not to be used or closed
+ */
+extern bool t4_stream_open(t4_stream_t * self, FILE * file);
+
+/**
+ * @brief Stops the reader thread and frees the buffers, file is not closed.
+ */
+extern void t4_stream_close(t4_stream_t * self);
+
+/**
+ * @brief The next part of the input, ending right after an ASCII separator (see @ref t4_tokenize_split_point), or
+ * at the end of the input. Only when a whole chunk has no such separator is it cut at the chunk boundary.
+ *
+ * @param data Set to the part, writable and valid until the next call
+ * @return false once the input is exhausted or reading failed, see @ref t4_stream_failed
+ */
+extern bool t4_stream_next(t4_stream_t * self, char ** data, size_t * size);
+
+static inline bool t4_stream_failed(const t4_stream_t * self) {
+    return self->failed;
+}
+
+#endif /* T4_STREAM_H_ */
@@ -0,0 +1,303 @@
+#ifndef T4_STREE_H_
+#define T4_STREE_H_
+
+#include "t4/common.h"
+#include "t4/stset.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <string.h>
+
+/**
+ * A static search tree over a fixed set of keys kept in order, for a dictionary that never changes: unlike a hash,
+ * it also answers which keys come right before and after one that is not there, eg. the nearest dictionary words.
+ *
+ * Keys are ordered by their bytes with ASCII case folded, then by their own bytes, so words that only differ in
+ * case are next to each other and one tree answers both exact and case-insensitive lookups. Only the first 8
+ * bytes of each key, folded and big-endian, are in the tree itself: an S+ tree of nodes of T4_STREE_B of those
+ * prefixes, a cache line each, whose bottom layer is the prefixes of all keys in order. Descending it compares a
+ * whole node at once (t4_internal_stree_search_avx2 does it with two AVX2 compares) and ends at the first key
+ * with at least the prefix looked up; keys sharing that prefix are then told apart by comparing them in full.
+ * Every level of the descent waits for the one before, so the batch lookups descend several keys in lockstep,
+ * where the SIMD compares pay off; a single lookup is all latency, which the plain compares have less of.
+ *
+ * Everything lives in one flat image, made by t4_stree_build (t4_mkstree does it at build time for t4) and used in
+ * place, like a t4_phf. It is, with every part aligned to 64:
+ *  - a header: magic, format version and sizes;
+ *  - the layers of the tree, bottom one first, padded with T4_STREE_NONE_PREFIX to whole nodes;
+ *  - the offsets, a u32 per key and one more, key i being the bytes from offsets[i] to offsets[i + 1];
+ *  - the keys, back to back in order.
+ */
+
+/* Prefixes per node, 8 bytes each */
+#define T4_STREE_B 8
+
+/* Enough for 2^32 keys */
+#define T4_STREE_MAX_HEIGHT 16
+
+/* Keys descending the tree together in the batch lookups */
+#define T4_STREE_BATCH 16
+
+/* Pads the layers; greater than any key's prefix, which is why no key may start with 8 bytes of 0xff. */
+#define T4_STREE_NONE_PREFIX INT64_MAX
+
+/* Bumped whenever the image layout or the order changes */
+#define T4_STREE_VERSION 1
+
+typedef struct t4_stree {
+    size_t num_keys;
+    size_t height;
+    /* Where each layer starts in tree, in prefixes; layer 0 is the bottom one */
+    size_t layers[T4_STREE_MAX_HEIGHT];
+
+    const i64 * tree;
+    const u32 * offsets;
+    const u8 * keys;
+
+    /*
+     * Sets res[i] to the index of the first key in layer 0 with at least prefixes[i], some index of the padding
+     * past the last key if none; see t4_stree_prefix. Only used by the batch lookups.
+     */
+    void (*search)(const struct t4_stree * self, const i64 * prefixes, size_t n, size_t * res);
+} t4_stree_t;
+
+/**
+ * @brief Builds the image of a set of keys, which must all be distinct; keys only differing in case are fine.
+ *
+ * @param size Set to the size of the image
+ * @return The image, to be freed with t4_free, or NULL if it cannot be built (duplicates, a key starting with 8
+ *         bytes of 0xff, or more than 2^32 - 1 keys or bytes of keys)
+ */
+extern u8 * t4_stree_build(const t4_stset_key_t * keys, size_t n, size_t * size);
+
+/**
+ * @brief Points self into an image made by @ref t4_stree_build, picking the search for this CPU; the image must
+ * stay where it is as long as self is used, and be 64-byte aligned. Only the header is checked.
+ *
+ * @return false if it is not such an image, or one of another version
+ */
+extern bool t4_stree_open(t4_stree_t * self, const void * image, size_t size);
+
+/* Prefixes of the node less than prefix; they are in order, so these are its first ones. */
+static inline size_t t4_stree_rank(const i64 * node, const i64 prefix) {
+    size_t res = 0;
+
+    for (size_t j = 0; j < T4_STREE_B; j++) {
+        res += prefix > node[j];
+    }
+
+    return res;
+}
+
+/* t4_stree_t.search of a single prefix, with plain compares. */
+static inline size_t t4_stree_descend(const t4_stree_t * self, const i64 prefix) {
+    size_t k = 0;
+
+    for (size_t h = self->height - 1; h > 0; h--) {
+        k = k * (T4_STREE_B + 1) + t4_stree_rank(self->tree + self->layers[h] + k, prefix) * T4_STREE_B;
+    }
+
+    return k + t4_stree_rank(self->tree + k, prefix);
+}
+
+/* Backends of t4_stree_t.search, picked by t4_stree_open; the batch lookups are where the AVX2 one pays off. */
+extern void t4_internal_stree_search_scalar(const t4_stree_t * self, const i64 * prefixes, size_t n, size_t * res);
+extern void t4_internal_stree_search_avx2(const t4_stree_t * self, const i64 * prefixes, size_t n, size_t * res);
+
+/* The first 8 bytes of a key, zero padded and folded, big-endian with the top bit flipped so signed compares order them. */
+static inline i64 t4_stree_prefix(const void * data, const size_t size) {
+    u64 x = 0;
+    memcpy(&x, data, size < 8 ? size : 8);
+
+    return (i64)(__builtin_bswap64(t4_ascii_fold8(x)) ^ (1llu << 63));
+}
+
+/* Orders keys as the tree does; with fold, keys only differing in ASCII case compare equal. */
+static inline int t4_stree_compare(const void * a, const size_t a_size, const void * b, const size_t b_size, const bool fold) {
+    const u8 * p = a;
+    const u8 * q = b;
+    const size_t n = a_size < b_size ? a_size : b_size;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        u64 x, y;
+        memcpy(&x, p + i, 8);
+        memcpy(&y, q + i, 8);
+        x = __builtin_bswap64(t4_ascii_fold8(x));
+        y = __builtin_bswap64(t4_ascii_fold8(y));
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+
+    for (; i < n; i++) {
+        const u8 x = t4_ascii_fold(p[i]);
+        const u8 y = t4_ascii_fold(q[i]);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+
+    if (a_size != b_size) {
+        return a_size < b_size ? -1 : 1;
+    }
+
+    const int res = fold ? 0 : memcmp(a, b, n);
+    return (res > 0) - (res < 0);
+}
+
+/* Key i, in order. */
+static inline const u8 * t4_stree_key(const t4_stree_t * self, const size_t i, size_t * size) {
+    *size = self->offsets[i + 1] - self->offsets[i];
+    return self->keys + self->offsets[i];
+}
+
+static inline size_t t4_stree_size(const t4_stree_t * self) {
+    return self->num_keys;
+}
+
+/* Whether key i comes before the one looked up, which has the given prefix. */
+static T4_INLINE bool t4_stree_before(const t4_stree_t * self, const size_t i, const void * data, const size_t size,
+                                      const i64 prefix, const bool fold) {
+    if (i >= self->num_keys || self->tree[i] != prefix) {
+        return false;
+    }
+
+    size_t key_size;
+    const u8 * key = t4_stree_key(self, i, &key_size);
+    return t4_stree_compare(key, key_size, data, size, fold) < 0;
+}
+
+/* The lower bound of data, from lo, the first key with at least its prefix, as t4_stree_t.search found it. */
+static T4_INLINE size_t t4_stree_seek(const t4_stree_t * self, size_t lo, const void * data, const size_t size,
+                                      const i64 prefix, const bool fold) {
+    lo = lo < self->num_keys ? lo : self->num_keys;
+
+    /* Keys sharing the prefix are next to each other, and usually few: gallop over them, then bisect. */
+    size_t hi = lo;
+    for (size_t step = 1; t4_stree_before(self, hi, data, size, prefix, fold); step *= 2) {
+        lo = hi + 1;
+        hi += step;
+    }
+
+    hi = hi < self->num_keys ? hi : self->num_keys;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (t4_stree_before(self, mid, data, size, prefix, fold)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static T4_INLINE size_t t4_stree_lower_bound_impl(const t4_stree_t * self, const void * data, const size_t size, const bool fold) {
+    const i64 prefix = t4_stree_prefix(data, size);
+
+    return t4_stree_seek(self, t4_stree_descend(self, prefix), data, size, prefix, fold);
+}
+
+/* Whether key i is data. */
+static T4_INLINE bool t4_stree_is_key(const t4_stree_t * self, const size_t i, const void * data, const size_t size, const bool fold) {
+    if (i == self->num_keys) {
+        return false;
+    }
+
+    size_t key_size;
+    const u8 * key = t4_stree_key(self, i, &key_size);
+    if (key_size != size) {
+        return false;
+    }
+
+    return fold ? t4_ascii_eq_folded(key, data, size) : memcmp(key, data, size) == 0;
+}
+
+/**
+ * @return The index of the first key not before data, ie. where it is or would be in order; t4_stree_size if
+ *         every key is before it
+ */
+static inline size_t t4_stree_lower_bound(const t4_stree_t * self, const void * data, const size_t size) {
+    return t4_stree_lower_bound_impl(self, data, size, false);
+}
+
+static T4_INLINE bool t4_stree_exists_impl(const t4_stree_t * self, const void * data, const size_t size, const bool fold) {
+    return t4_stree_is_key(self, t4_stree_lower_bound_impl(self, data, size, fold), data, size, fold);
+}
+
+static inline bool t4_stree_exists(const t4_stree_t * self, const void * data, const size_t size) {
+    return t4_stree_exists_impl(self, data, size, false);
+}
+
+/* Same as @ref t4_stree_exists, but with ASCII case ignored, like a t4_stset with fold_case. */
+static inline bool t4_stree_exists_folded(const t4_stree_t * self, const void * data, const size_t size) {
+    return t4_stree_exists_impl(self, data, size, true);
+}
+
+static T4_INLINE void t4_stree_exists_batch_impl(const t4_stree_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result, const bool fold) {
+    i64 prefixes[T4_STREE_BATCH];
+    size_t found[T4_STREE_BATCH];
+
+    memset(result, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+
+    for (size_t base = 0; base < n; base += T4_STREE_BATCH) {
+        const size_t len = n - base < T4_STREE_BATCH ? n - base : T4_STREE_BATCH;
+
+        for (size_t i = 0; i < len; i++) {
+            prefixes[i] = t4_stree_prefix(keys[base + i].data, keys[base + i].size);
+        }
+
+        self->search(self, prefixes, len, found);
+
+        for (size_t i = 0; i < len; i++) {
+            const t4_stset_key_t * key = keys + base + i;
+            const size_t lo = t4_stree_seek(self, found[i], key->data, key->size, prefixes[i], fold);
+            const u64 is_key = t4_stree_is_key(self, lo, key->data, key->size, fold);
+
+            result[(base + i) / 64] |= is_key << ((base + i) % 64);
+        }
+    }
+}
+
+/* Sets bit i of result (T4_STSET_BITMAP_WORDS(n) words) if keys[i] is in self, like t4_stset_exists_batch. */
+static inline void t4_stree_exists_batch(const t4_stree_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    t4_stree_exists_batch_impl(self, keys, n, result, false);
+}
+
+/* Same as @ref t4_stree_exists_batch, but with ASCII case ignored. */
+static inline void t4_stree_exists_batch_folded(const t4_stree_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    t4_stree_exists_batch_impl(self, keys, n, result, true);
+}
+
+/**
+ * @brief The last key before data, whether data is a key or not.
+ *
+ * @return false if there is none
+ */
+static inline bool t4_stree_predecessor(const t4_stree_t * self, const void * data, const size_t size, size_t * index) {
+    const size_t i = t4_stree_lower_bound(self, data, size);
+
+    *index = i - 1;
+    return i != 0;
+}
+
+/**
+ * @brief The first key after data, whether data is a key or not.
+ *
+ * @return false if there is none
+ */
+static inline bool t4_stree_successor(const t4_stree_t * self, const void * data, const size_t size, size_t * index) {
+    size_t i = t4_stree_lower_bound(self, data, size);
+
+    if (i != self->num_keys) {
+        size_t key_size;
+        const u8 * key = t4_stree_key(self, i, &key_size);
+        i += key_size == size && memcmp(key, data, size) == 0;
+    }
+
+    *index = i;
+    return i != self->num_keys;
+}
+
+#endif /* T4_STREE_H_ */
@@ -2,59 +2,369 @@
 #define T4_STSET_H_
 
 #include "t4/common.h"
+#include "t4/arena.h"
 #include "t4/internal/stset_vtable.h"
+#include "t4/internal/stset_hash.h"
 
-// TODO Consider adding flags to disable dynamic dispatch
+/**
+ * How calls reach a backend is chosen at build time (T4_STSET_DISPATCH in CMakeLists.txt):
+ *  - by default every call goes through t4_internal_stset_vtable, filled in by t4_internal_stset_init();
+ *  - T4_STSET_IFUNC turns the functions below into GNU ifuncs, resolved once by the dynamic loader;
+ *  - T4_STSET_STATIC_{SCALAR,SSE2,AVX2,AVX512} pins one backend and includes its implementation here, so the
+ *    probe loop can be inlined into the caller. Every file including this header must then be built with the
+ *    flags of that backend.
+ */
+#if defined(T4_STSET_STATIC_AVX512)
+#   define T4_STSET_STATIC_BACKEND avx512
+#elif defined(T4_STSET_STATIC_AVX2)
+#   define T4_STSET_STATIC_BACKEND avx2
+#elif defined(T4_STSET_STATIC_SSE2)
+#   define T4_STSET_STATIC_BACKEND sse2
+#elif defined(T4_STSET_STATIC_SCALAR)
+#   define T4_STSET_STATIC_BACKEND scalar
+#endif
+
+#if defined(T4_STSET_STATIC_BACKEND) && defined(T4_STSET_IFUNC)
+#   error "T4_STSET_IFUNC and T4_STSET_STATIC_* are mutually exclusive."
+#endif
+
+/* Keys up to this long are copied into their entry, so comparing them never leaves the entries array */
+#define T4_STSET_INLINE 16
+
+/* Size of a removed entry */
+#define T4_STSET_REMOVED UINT32_MAX
 
 typedef struct t4_stset_entry {
-    u64 hash;
-    void * data;
-    size_t size;
+    union {
+        /* Longer keys are only copied by owning sets, otherwise they must outlive the set */
+        void * data;
+
+        /* Zero padded */
+        u8 bytes[T4_STSET_INLINE];
+    };
+
+    /* T4_STSET_REMOVED once the key has been removed */
+    u32 size;
+
+    /* Low half of the t4 hash, all the set needs of it to place the key again */
+    u32 hash;
 } t4_stset_entry_t;
 
+/* Used by t4_stset_new, change it per set with t4_stset_set_max_load_factor */
+#define T4_STSET_DEFAULT_MAX_LOAD_FACTOR 0.875f
+
+/**
+ * The slots only hold the metadata and a 32-bit index into entries, which are packed in insertion order. Keys must
+ * therefore be shorter than 4 GiB - 1, and a set holds fewer than 2^32 of them.
+ */
 typedef struct t4_stset {
     size_t capacity;
-    t4_stset_entry_t * entries;
 
     /* This must to be aligned */
     u8 * metadata;
+    u32 * index;
+
+    /* Every key inserted since the last rebuild, removed ones included, see t4_stset_next */
+    t4_stset_entry_t * entries;
+    size_t num_entries;
+    size_t entries_capacity;
+
+    /* Number of keys, and of slots holding the tombstone of a removed one */
+    size_t size;
+    size_t tombstones;
+
+    /* Empty slots that can still be filled before the set has to grow or get rid of its tombstones */
+    size_t growth_left;
+
+    float max_load_factor;
+
+    /* Set by t4_stset_set_fold_case; keys are then hashed and compared with ASCII letters folded to lowercase */
+    bool fold_case;
+
+    /* Set by t4_stset_new_owning; keys longer than T4_STSET_INLINE are then copied into arena */
+    bool owns_keys;
+    t4_arena_t arena;
+
+    /* Only set in a snapshot (t4/stset_snapshot.h), whose longer keys are then offsets from here instead of pointers */
+    const u8 * key_base;
+
+    /* Only used by t4_stmap: a value_size byte value for every one of entries, in the same order */
+    size_t value_size;
+    u8 * values;
 } t4_stset_t;
 
+/* One key of a batch operation */
+typedef struct t4_stset_key {
+    void * data;
+    size_t size;
+} t4_stset_key_t;
+
+/* Number of u64 words a batch result bitmap needs for n keys */
+#define T4_STSET_BITMAP_WORDS(n) (((n) + 63) / 64)
+
+static inline bool t4_stset_bitmap_get(const u64 * bitmap, const size_t i) {
+    return (bitmap[i / 64] >> (i % 64)) & 1;
+}
+
+/* Result flags of t4_stset_try_insert_exists */
+enum t4_stset_insert_result {
+    T4_STSET_INSERTED = 1 << 0,
+    T4_STSET_IN_OTHER = 1 << 1,
+};
+
+/* How many slots of a set with this capacity may be used (filled or deleted) at most. At least one is always kept
+ * empty, which is what ends the probe of a missing key. */
+static inline size_t t4_stset_max_used(const size_t capacity, const float max_load_factor) {
+    const size_t max = (size_t)((double)capacity * max_load_factor);
+
+    return max >= capacity ? capacity - 1 : max == 0 ? 1 : max;
+}
+
+static inline size_t t4_stset_size(const t4_stset_t * self) {
+    return self->size;
+}
+
+/* Where the bytes of a key of the set are, in the entry itself or wherever the caller had it */
+static inline const void * t4_stset_entry_data(const t4_stset_t * self, const t4_stset_entry_t * e) {
+    /* key_base is NULL everywhere but in a snapshot, so this is the pointer itself for every other set. */
+    return e->size <= T4_STSET_INLINE ? (const void *)e->bytes : (const void *)((uintptr_t)self->key_base + (uintptr_t)e->data);
+}
+
+/**
+ * @brief Walks the keys in the order they were inserted, eg.
+ * for (size_t it = 0; (e = t4_stset_next(set, &it)) != NULL;) { ... }
+ *
+ * @param it Zero to start with; the set must not be changed until the walk is done
+ * @return The next key, or NULL after the last one
+ */
+static inline const t4_stset_entry_t * t4_stset_next(const t4_stset_t * self, size_t * it) {
+    while (*it < self->num_entries) {
+        const t4_stset_entry_t * e = self->entries + (*it)++;
+        if (e->size != T4_STSET_REMOVED) {
+            return e;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Sets the fraction of slots that may be used before the next insert grows the set (or rehashes it in
+ * place, when enough of them are tombstones). Takes effect immediately, the set is not shrunk though.
+ *
+ * @param max_load_factor In (0, 1], defaults to T4_STSET_DEFAULT_MAX_LOAD_FACTOR
+ */
+static inline void t4_stset_set_max_load_factor(t4_stset_t * self, const float max_load_factor) {
+    const size_t max = t4_stset_max_used(self->capacity, max_load_factor);
+    const size_t used = self->size + self->tombstones;
+
+    self->max_load_factor = max_load_factor;
+    self->growth_left = max > used ? max - used : 0;
+}
+
+/**
+ * @brief Makes the set ignore ASCII case, so "Word", "WORD" and "word" are the same key, without the caller having
+ * to lowercase anything: keys are hashed and compared with 'A'..'Z' folded on the fly, 8 or 16 bytes at a time. A
+ * key is kept the way it was first inserted. Other bytes are compared as they are, so text that is not ASCII still
+ * has to be folded by the caller. Only valid before the first insert.
+ */
+static inline void t4_stset_set_fold_case(t4_stset_t * self, const bool fold_case) {
+    t4_debug_assert(self->num_entries == 0);
+
+    self->fold_case = fold_case;
+}
+
+/**
+ * @brief Hashes a key the same way every set without fold_case does, for the *_with_hash functions. The seed is
+ * shared by all sets, so one hash is valid for any of them, but only once the first set has been created.
+ */
+static inline u64 t4_stset_hash(const void * data, const size_t data_size) {
+    return t4_make_hash_h1h2(data, data_size);
+}
+
+/* Same as @ref t4_stset_hash, but for this set in particular; the only one valid for sets with fold_case. */
+static inline u64 t4_stset_hash_for(const t4_stset_t * self, const void * data, const size_t data_size) {
+    return t4_make_hash_h1h2_for(data, data_size, self->fold_case);
+}
+
+#if defined(T4_STSET_IFUNC)
+
+/* Resolved once at load time by src/stset.c, see t4_stset_resolve_vtable. */
+extern size_t t4_stset_get_alignment(void);
+extern t4_stset_t t4_stset_new(size_t capacity);
+extern void t4_stset_free(t4_stset_t * self);
+extern void t4_stset_insert_unchecked(t4_stset_t * self, void * data, size_t data_size);
+extern bool t4_stset_try_insert(t4_stset_t * self, void * data, size_t data_size);
+extern bool t4_stset_exists(const t4_stset_t * self, const void * data, size_t data_size);
+extern void t4_stset_insert_unchecked_with_hash(t4_stset_t * self, u64 hash, void * data, size_t data_size);
+extern bool t4_stset_try_insert_with_hash(t4_stset_t * self, u64 hash, void * data, size_t data_size);
+extern bool t4_stset_exists_with_hash(const t4_stset_t * self, u64 hash, const void * data, size_t data_size);
+extern bool t4_stset_remove(t4_stset_t * self, const void * data, size_t data_size);
+extern bool t4_stset_remove_with_hash(t4_stset_t * self, u64 hash, const void * data, size_t data_size);
+extern u32 t4_stset_try_insert_exists(t4_stset_t * self, const t4_stset_t * other, void * data, size_t data_size);
+extern void t4_stset_try_insert_batch(t4_stset_t * self, const t4_stset_key_t * keys, size_t n, u64 * result);
+extern void t4_stset_exists_batch(const t4_stset_t * self, const t4_stset_key_t * keys, size_t n, u64 * result);
+extern void t4_stset_try_insert_exists_batch(t4_stset_t * self, const t4_stset_t * other, const t4_stset_key_t * keys, size_t n, u64 * inserted, u64 * in_other);
+extern size_t t4_stset_probe_length(const t4_stset_t * self, const void * data, size_t data_size);
+extern void * t4_stset_map_upsert(t4_stset_t * self, void * data, size_t data_size, bool * inserted);
+extern void * t4_stset_map_get(const t4_stset_t * self, const void * data, size_t data_size);
+
+#else
+
+#if defined(T4_STSET_STATIC_BACKEND)
+#   if defined(T4_STSET_STATIC_AVX512)
+#       include "t4/internal/stset_group_avx512.h"
+#   elif defined(T4_STSET_STATIC_AVX2)
+#       include "t4/internal/stset_group_avx2.h"
+#   elif defined(T4_STSET_STATIC_SSE2)
+#       include "t4/internal/stset_group_sse2.h"
+#   else
+#       include "t4/internal/stset_group_scalar.h"
+#   endif
+
+#   define T4_STSET_BACKEND T4_STSET_STATIC_BACKEND
+#   include "t4/internal/stset_impl.h"
+
+#   define T4_STSET_CALL(fn) T4_CONCAT(t4_stset_##fn, T4_STSET_STATIC_BACKEND)
+#else
+#   define T4_STSET_CALL(fn) t4_internal_stset_vtable.fn
+#endif
+
 /**
  * @brief First call is not thread-safe; the first call to either this or @ref t4_stset_new
- * will initialise the internal vtable and set the seed.
+ * will initialise the internal vtable and set the seed. With static dispatch both happen before main.
  *
  * @return The alignment used for SIMD operations, eg. AVX2: 32
  */
 static inline size_t t4_stset_get_alignment(void) {
-    return t4_internal_stset_vtable.get_alignment();
+    return T4_STSET_CALL(get_alignment)();
 }
 
 /**
  * @brief First call is not thread-safe; the first call to either this or @ref t4_stset_get_alignment
  * will initialise the internal vtable and set the seed.
  *
- * @param capacity Initial capacity for the set (1024 at minimum)
+ * @param capacity Initial capacity for the set, rounded up to a power of two (1024 at minimum)
  * @return The newly created stset instance
  */
 static inline t4_stset_t t4_stset_new(const size_t capacity) {
-    return t4_internal_stset_vtable.new(capacity);
+    return T4_STSET_CALL(new)(capacity);
 }
 
 static inline void t4_stset_free(t4_stset_t * self) {
-    t4_internal_stset_vtable.free(self);
+    T4_STSET_CALL(free)(self);
 }
 
 static inline void t4_stset_insert_unchecked(t4_stset_t * self, void * data, const size_t data_size) {
-    t4_internal_stset_vtable.insert_unchecked(self, data, data_size);
+    T4_STSET_CALL(insert_unchecked)(self, data, data_size);
 }
 
 static inline bool t4_stset_try_insert(t4_stset_t * self, void * data, const size_t data_size) {
-    return t4_internal_stset_vtable.try_insert(self, data, data_size);
+    return T4_STSET_CALL(try_insert)(self, data, data_size);
 }
 
 static inline bool t4_stset_exists(const t4_stset_t * self, const void * data, const size_t data_size) {
-    return t4_internal_stset_vtable.exists(self, data, data_size);
+    return T4_STSET_CALL(exists)(self, data, data_size);
+}
+
+/**
+ * @brief Removes a key. Its slot becomes a tombstone unless nothing can probe past it; tombstones are reused by
+ * later inserts and cleared by an in-place rehash once they take up too much of the set.
+ *
+ * @return false if the key was not in the set
+ */
+static inline bool t4_stset_remove(t4_stset_t * self, const void * data, const size_t data_size) {
+    return T4_STSET_CALL(remove)(self, data, data_size);
+}
+
+/* The *_with_hash variants take the result of @ref t4_stset_hash_for for the same key, so a key probed in several
+ * sets is only hashed once. */
+
+static inline void t4_stset_insert_unchecked_with_hash(t4_stset_t * self, const u64 hash, void * data, const size_t data_size) {
+    T4_STSET_CALL(insert_unchecked_with_hash)(self, hash, data, data_size);
+}
+
+static inline bool t4_stset_try_insert_with_hash(t4_stset_t * self, const u64 hash, void * data, const size_t data_size) {
+    return T4_STSET_CALL(try_insert_with_hash)(self, hash, data, data_size);
+}
+
+static inline bool t4_stset_exists_with_hash(const t4_stset_t * self, const u64 hash, const void * data, const size_t data_size) {
+    return T4_STSET_CALL(exists_with_hash)(self, hash, data, data_size);
+}
+
+static inline bool t4_stset_remove_with_hash(t4_stset_t * self, const u64 hash, const void * data, const size_t data_size) {
+    return T4_STSET_CALL(remove_with_hash)(self, hash, data, data_size);
+}
+
+/**
+ * @brief Inserts the key into self and, only if it was new, checks whether it exists in other. Both must have the
+ * same fold_case.
+ *
+ * @return 0 if the key was already in self, otherwise T4_STSET_INSERTED, plus T4_STSET_IN_OTHER if other has it
+ */
+static inline u32 t4_stset_try_insert_exists(t4_stset_t * self, const t4_stset_t * other, void * data, const size_t data_size) {
+    return T4_STSET_CALL(try_insert_exists)(self, other, data, data_size);
+}
+
+/**
+ * @brief Same as calling @ref t4_stset_try_insert on every key in order, but the hashing and the first cache
+ * miss of every probe are overlapped across keys.
+ *
+ * @param result Bitmap of T4_STSET_BITMAP_WORDS(n) words, bit i is set if keys[i] was inserted
+ */
+static inline void t4_stset_try_insert_batch(t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    T4_STSET_CALL(try_insert_batch)(self, keys, n, result);
+}
+
+/**
+ * @brief Same as calling @ref t4_stset_exists on every key, with the cache misses overlapped across keys.
+ *
+ * @param result Bitmap of T4_STSET_BITMAP_WORDS(n) words, bit i is set if keys[i] exists
+ */
+static inline void t4_stset_exists_batch(const t4_stset_t * self, const t4_stset_key_t * keys, const size_t n, u64 * result) {
+    T4_STSET_CALL(exists_batch)(self, keys, n, result);
+}
+
+/**
+ * @brief Batched @ref t4_stset_try_insert_exists.
+ *
+ * @param inserted Bitmap of T4_STSET_BITMAP_WORDS(n) words, bit i is set if keys[i] was inserted into self
+ * @param in_other Same size, bit i is set if keys[i] was inserted and exists in other
+ */
+static inline void t4_stset_try_insert_exists_batch(t4_stset_t * self, const t4_stset_t * other, const t4_stset_key_t * keys, const size_t n, u64 * inserted, u64 * in_other) {
+    T4_STSET_CALL(try_insert_exists_batch)(self, other, keys, n, inserted, in_other);
+}
+
+/**
+ * @brief For measuring the probe sequence, not for use in hot paths.
+ *
+ * @return How many groups a lookup of the key loads, whether or not it is in the set
+ */
+static inline size_t t4_stset_probe_length(const t4_stset_t * self, const void * data, const size_t data_size) {
+    return T4_STSET_CALL(probe_length)(self, data, data_size);
+}
+
+/* The engine of t4/stmap.h, only valid on sets created by t4_stmap_new. */
+
+static inline void * t4_stset_map_upsert(t4_stset_t * self, void * data, const size_t data_size, bool * inserted) {
+    return T4_STSET_CALL(map_upsert)(self, data, data_size, inserted);
+}
+
+static inline void * t4_stset_map_get(const t4_stset_t * self, const void * data, const size_t data_size) {
+    return T4_STSET_CALL(map_get)(self, data, data_size);
+}
+
+#endif /* T4_STSET_IFUNC */
+
+/**
+ * @brief Same as @ref t4_stset_new, but the set keeps its own copy of every key, so the buffers they were inserted
+ * from can be reused or freed right away. The copies are packed into chunks in insertion order and freed along with
+ * the set; a removed key's copy stays until then.
+ */
+static inline t4_stset_t t4_stset_new_owning(const size_t capacity) {
+    t4_stset_t set = t4_stset_new(capacity);
+    set.owns_keys = true;
+    return set;
 }
 
 #endif /* T4_STSET_H_ */
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef T4_STSET_SHARDED_H_
+#define T4_STSET_SHARDED_H_
+
+#include "t4/common.h"
+#include "t4/stset.h"
+
+#include <stdatomic.h>
+
+/* Each shard on its own cache line(s), so threads working on different shards never share one. */
+typedef struct t4_stset_shard {
+    alignas(64) atomic_bool locked;
+    t4_stset_t set;
+} t4_stset_shard_t;
+
+/**
+ * A t4_stset split into independently locked shards, for many threads inserting at once. The shard of a key comes
+ * from the high half of its hash, which the sets themselves never look at, so every shard still sees well spread
+ * hashes. Each key lives in exactly one shard and is only ever inserted under its lock, so try_insert reports it
+ * as new exactly once no matter how many threads race on it.
+ *
+ * Creating and freeing the set is not thread-safe, everything else is.
+ */
+typedef struct t4_stset_sharded {
+    t4_stset_shard_t * shards;
+    size_t num_shards;
+} t4_stset_sharded_t;
+
+/**
+ * @param capacity Expected number of keys in total, split evenly between the shards
+ * @param num_shards Rounded up to a power of two; a few times the number of threads keeps contention low
+ */
+extern t4_stset_sharded_t t4_stset_sharded_new(size_t capacity, size_t num_shards);
+
+/* Same as @ref t4_stset_sharded_new, but every shard copies its keys like @ref t4_stset_new_owning */
+extern t4_stset_sharded_t t4_stset_sharded_new_owning(size_t capacity, size_t num_shards);
+
+extern void t4_stset_sharded_free(t4_stset_sharded_t * self);
+
+extern bool t4_stset_sharded_try_insert(t4_stset_sharded_t * self, void * data, size_t data_size);
+extern bool t4_stset_sharded_exists(t4_stset_sharded_t * self, const void * data, size_t data_size);
+
+/**
+ * @brief Same as @ref t4_stset_try_insert_exists. other is only read, and outside of any lock, so it must not be
+ * changed while this runs.
+ */
+extern u32 t4_stset_sharded_try_insert_exists(t4_stset_sharded_t * self, const t4_stset_t * other, void * data, size_t data_size);
+
+/* Only exact while no other thread is inserting. */
+extern size_t t4_stset_sharded_size(const t4_stset_sharded_t * self);
+
+#endif /* T4_STSET_SHARDED_H_ */
@@ -0,0 +1,67 @@
+#ifndef T4_STSET_SNAPSHOT_H_
+#define T4_STSET_SNAPSHOT_H_
+
+#include "t4/common.h"
+#include "t4/stset.h"
+
+/**
+ * A t4_stset written out to a file exactly as it is laid out in memory, so it can be mapped and probed right away
+ * instead of being built again by every process; processes mapping the same file all share one copy of it in the
+ * page cache. The file is, with every part starting at a multiple of T4_STSET_SNAPSHOT_ALIGN:
+ *  - a header: magic, format version, the group width and probing of the backend, fold_case, the hash seed, the
+ *    sizes of the set and where every other part is;
+ *  - metadata, capacity bytes;
+ *  - index, capacity u32s;
+ *  - entries, as t4_stset_entry_t, except that the data of a key longer than T4_STSET_INLINE is its offset into
+ *    the key blob, see t4_stset_t.key_base;
+ *  - the key blob, the longer keys back to back.
+ *
+ * Where a key lives depends on the group width and on the seed, so a snapshot is only valid for a build probing
+ * with the same group width (usually the same backend, see T4_STSET_ISA) and the same T4_STSET_LINEAR_PROBING.
+ * All sets hash with one seed, so loading a snapshot switches every set over to its seed: it has to happen before
+ * any other set gets its first key, and every snapshot loaded has to share the seed.
+ *
+ * Only the header is checked when loading, the rest is trusted as is.
+ */
+typedef struct t4_stset_snapshot {
+    /* Read-only: nothing may be inserted into or removed from it, nor may it be freed with t4_stset_free */
+    t4_stset_t set;
+
+    void * map;
+    size_t map_size;
+} t4_stset_snapshot_t;
+
+/* Alignment of every part of the file, the widest group there is, so the mapped metadata is aligned for any backend */
+#define T4_STSET_SNAPSHOT_ALIGN 64
+
+/* Bumped whenever the file format or the hash changes */
+#define T4_STSET_SNAPSHOT_VERSION 1
+
+enum t4_stset_snapshot_status {
+    T4_STSET_SNAPSHOT_OK,
+    /* The file could not be opened, read or mapped, see errno */
+    T4_STSET_SNAPSHOT_IO_ERROR,
+    /* Not a snapshot, a truncated one or one of another format version */
+    T4_STSET_SNAPSHOT_BAD_FORMAT,
+    /* Made by a build probing another way, or with another seed than an already loaded snapshot */
+    T4_STSET_SNAPSHOT_MISMATCH,
+};
+
+/**
+ * @brief Writes a set to path, through a temporary file renamed over it at the end, so processes that still have
+ * the old one mapped keep working. The set must not be a map nor have had keys removed from it.
+ *
+ * @return false if the file could not be written, see errno
+ */
+extern bool t4_stset_snapshot_write(const t4_stset_t * set, const char * path);
+
+/**
+ * @brief Maps a snapshot written by @ref t4_stset_snapshot_write. Pages are only read in as probes reach them.
+ *
+ * @param self Untouched unless T4_STSET_SNAPSHOT_OK is returned
+ */
+extern enum t4_stset_snapshot_status t4_stset_snapshot_load(t4_stset_snapshot_t * self, const char * path);
+
+extern void t4_stset_snapshot_free(t4_stset_snapshot_t * self);
+
+#endif /* T4_STSET_SNAPSHOT_H_ */
@@ -0,0 +1,106 @@
+#ifndef T4_TOKENIZE_H_
+#define T4_TOKENIZE_H_
+
+#include "t4/common.h"
+
+/* One word, at buf + offset of the tokenized buffer. */
+typedef struct t4_token {
+    size_t offset;
+    size_t size;
+} t4_token_t;
+
+/* A single block can end at most this many words, see @ref t4_tokenize */
+#define T4_TOKENIZE_BLOCK_TOKENS 16
+
+/* Set while no word has been started yet. */
+#define T4_TOKENIZE_NO_WORD SIZE_MAX
+
+/* Whether c is A-Z or a-z: only letters end up in 'a'..'z' with 0x20 set. */
+static inline bool t4_is_ascii_letter(const char c) {
+    return (u8)(((u8)c | 0x20) - 'a') < 26;
+}
+
+/**
+ * @brief Where a buffer can be cut into pieces that tokenize the same as the whole: right after an ASCII byte
+ * that is not a letter, which can neither be part of a word nor of a multi-byte character.
+ *
+ * @return The first such position at or after pos, or size
+ */
+static inline size_t t4_tokenize_split_point(const char * buf, const size_t size, size_t pos) {
+    while (pos < size && ((u8)buf[pos] >= 0x80 || t4_is_ascii_letter(buf[pos]))) {
+        pos++;
+    }
+
+    return pos < size ? pos + 1 : size;
+}
+
+typedef struct t4_tokenizer t4_tokenizer_t;
+
+typedef size_t (*t4_tokenize_fn)(t4_tokenizer_t * self, t4_token_t * tokens, size_t max_tokens);
+
+/**
+ * Splits UTF-8 text into words, maximal runs of letters and combining marks, case folding them in place as it
+ * goes. Unlike isalpha and tolower this does not depend on the locale, and "café" or "naïve" stay whole words.
+ * Everything else separates words, including bytes that are not valid UTF-8. Folds that would change the encoded
+ * length of a character (eg. U+212A KELVIN SIGN to "k") are skipped so words never move; see gen_utf8_tables.py
+ * for which characters count.
+ *
+ * With AVX2 32 bytes are classified and lowercased at once, and the word boundaries of a block are taken from the
+ * set bits of (letters ^ (letters << 1)) one tzcnt at a time, so the cost scales with the number of words rather
+ * than the number of bytes. Only runs of non-ASCII bytes are decoded one character at a time.
+ */
+struct t4_tokenizer {
+    char * buf;
+    size_t size;
+    /* Next byte to classify */
+    size_t pos;
+    /* Start of the word pos is in, T4_TOKENIZE_NO_WORD between words */
+    size_t start;
+    /* Set by t4_tokenizer_new_readonly, buf is then never written to */
+    bool readonly;
+    /* Number of characters beyond ASCII that were part of words so far, which a read-only tokenizer leaves unfolded */
+    size_t non_ascii;
+    t4_tokenize_fn next;
+};
+
+/**
+ * @brief Picks the AVX2 implementation if the CPU has it. The tokenizer keeps no other state, so any number of
+ * them may run on separate threads.
+ *
+ * @param buf Written to, lowercased in place
+ */
+extern t4_tokenizer_t t4_tokenizer_new(char * buf, size_t size);
+
+/**
+ * @brief Same as @ref t4_tokenizer_new, but words are found without folding them, eg. in a read-only mapping of a
+ * file. They then have to be folded by whoever needs them to be: ASCII ones by a set with fold_case (see
+ * @ref t4_stset_set_fold_case), others by copying them out and calling @ref t4_tokenize_fold on the copy. A word
+ * needing the latter is returned by a call that increases non_ascii or by the one right after it, as a word can be
+ * cut between two calls.
+ */
+extern t4_tokenizer_t t4_tokenizer_new_readonly(const char * buf, size_t size);
+
+/**
+ * @brief Folds a single word the way t4_tokenizer_new would have, in place.
+ */
+extern void t4_tokenize_fold(char * word, size_t size);
+
+/**
+ * @brief Fills tokens with the next words of the buffer, in order; a word ending at the end of the buffer is
+ * returned too. Draining in batches of at least T4_TOKENIZE_BLOCK_TOKENS keeps the fast path busy, smaller ones
+ * are still correct.
+ *
+ * @return The number of tokens written, 0 once the whole buffer has been tokenized
+ */
+static inline size_t t4_tokenize(t4_tokenizer_t * self, t4_token_t * tokens, const size_t max_tokens) {
+    return self->next(self, tokens, max_tokens);
+}
+
+/* Backends, call them through t4_tokenize; t4_tokenizer_new picks the AVX2 one if the CPU has AVX2 and BMI1. */
+extern size_t t4_internal_tokenize_scalar(t4_tokenizer_t * self, t4_token_t * tokens, size_t max_tokens);
+
+/* Decodes whole characters from self->pos on while they start before end; may stop past end, never past size. */
+extern size_t t4_internal_tokenize_utf8(t4_tokenizer_t * self, t4_token_t * tokens, size_t max_tokens, size_t end);
+extern size_t t4_internal_tokenize_avx2(t4_tokenizer_t * self, t4_token_t * tokens, size_t max_tokens);
+
+#endif /* T4_TOKENIZE_H_ */
@@ -0,0 +1,34 @@
+#ifndef T4_TOPK_H_
+#define T4_TOPK_H_
+
+#include "t4/common.h"
+
+typedef struct t4_topk_item {
+    u64 score;
+    size_t id;
+} t4_topk_item_t;
+
+/**
+ * Keeps the k highest scoring of any number of items in a bounded min-heap, so picking them out of n costs
+ * O(n log k) time and O(k) memory instead of sorting all n. Equal scores are ranked by the lower id first, so
+ * feeding ids in insertion order gives the same result every run.
+ */
+typedef struct t4_topk {
+    t4_topk_item_t * items;
+    size_t len;
+    size_t k;
+} t4_topk_t;
+
+extern t4_topk_t t4_topk_new(size_t k);
+extern void t4_topk_free(t4_topk_t * self);
+
+extern void t4_topk_push(t4_topk_t * self, u64 score, size_t id);
+
+/**
+ * @brief Sorts the kept items from the highest score down. Pushing afterwards is not allowed.
+ *
+ * @return The number of items, k or fewer if fewer were pushed
+ */
+extern size_t t4_topk_sort(t4_topk_t * self);
+
+#endif /* T4_TOPK_H_ */
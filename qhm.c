@@ -265,7 +265,7 @@ qhm_entry_t * qhm_map_get(const qhm_map_t * m, const char * data, uint32_t data_
 
 /* hm code end */
 
-// FIXME this is completely broken lol
+/* Needs -mavx2 -mbmi */
 #define QHM_AVX2_TEST 0
 
 #if QHM_AVX2_TEST
@@ -314,93 +314,63 @@ t4_data_t t4_read_file(const char * fp) {
     return res;
 }
 
+static void t4_process_word(qhm_map_t * in, const qhm_map_t * eng, const char * w, const uint32_t length) {
+    if (qhm_map_try_insert(in, w, length)) {
+        qhm_entry_t * e = qhm_map_get(eng, w, length);
+
+        if (!e) {
+            printf("%.*s\n", length, w);
+        }
+    }
+}
+
+/* The library version of this, with a scalar fallback, is t4_tokenize in include/t4/tokenize.h. */
 void t4_process_avx2(qhm_map_t * in, const qhm_map_t * eng, char * data, const size_t data_size) {
     assert((uintptr_t)data % t4_alignment == 0);
     assert(data_size % t4_alignment == 0);
 
-    uint32_t length = 0;
-    size_t offset = 0;
-
-    const __m256i capital_b1 = _mm256_set1_epi8('A' - 1);
-    const __m256i capital_b2 = _mm256_set1_epi8('Z' + 1);
-
-    const __m256i lower_b1 = _mm256_set1_epi8('a' - 1);
-    const __m256i lower_b2 = _mm256_set1_epi8('z' + 1);
+    /* Start of the current word, or SIZE_MAX between words */
+    size_t start = SIZE_MAX;
 
-    const __m256i difference = _mm256_set1_epi8('a' - 'A');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i bias = _mm256_set1_epi8((char)(0x80 - 'a'));
+    const __m256i limit = _mm256_set1_epi8((char)(0x80 + 26));
 
     for (size_t chunk = 0; chunk < data_size; chunk += t4_alignment) {
         char * ptr = data + chunk;
 
-        __m256i curr = _mm256_load_si256((const __m256i *)ptr);
+        const __m256i curr = _mm256_load_si256((const __m256i *)ptr);
 
-        /* Make characters lowercase */
+        /* Only letters end up in 'a'..'z' with 0x20 set, which the bias moves to the 26 lowest signed bytes. */
+        const __m256i lower = _mm256_or_si256(curr, case_bit);
+        const __m256i matched = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(lower, bias));
 
-        __m256i matched = _mm256_and_si256(
-            _mm256_cmpgt_epi8(curr, capital_b1),
-            _mm256_cmpgt_epi8(capital_b2, curr));
+        _mm256_store_si256((__m256i *)ptr, _mm256_or_si256(curr, _mm256_and_si256(matched, case_bit)));
 
-        const __m256i tolower = _mm256_and_si256(matched, difference);
-        curr = _mm256_add_epi8(curr, tolower);
-
-        /* NOTE: I'm not sure whether this is good for performance. Streaming also exists, but
-         * do I use the data too early for that to be usable?
+        /*
+         * The old loop here stopped at the highest letter of the chunk, so a word ending inside it was glued to
+         * the next one. Every set bit of edges is a word starting or ending instead, including at bit 0, where the
+         * last byte of the previous chunk is carried in.
          */
-        _mm256_store_si256((__m256i *)ptr, curr);
-
-        /* Get all english letters */
-
-        matched = _mm256_and_si256(
-            _mm256_cmpgt_epi8(curr, lower_b1),
-            _mm256_cmpgt_epi8(lower_b2, curr));
-
-        uint32_t mask = _mm256_movemask_epi8(matched);
-
-        /* Process */
-
-        /* TODO bench this against a normal implementation */
+        const uint32_t mask = _mm256_movemask_epi8(matched);
+        uint32_t edges = mask ^ ((mask << 1) | (start != SIZE_MAX));
 
-        /* If mask has zero bits near the end, without this the offset will become incorrect. */
-        size_t skip = 32;
+        while (edges) {
+            const size_t i = chunk + _tzcnt_u32(edges);
 
-        do {
-            if (mask & 1) {
-                length += 1;
+            if (start == SIZE_MAX) {
+                start = i;
             } else {
-                if (length != 0) {
-                    // printf("%.*s\n", length, data + offset);
-                    const char * w = data + offset;
-                    
-                    if (qhm_map_try_insert(in, w, length)) {
-                        qhm_entry_t * e = qhm_map_get(eng, w, length);
-
-                        if (!e) {
-                            printf("%.*s\n", length, w);
-                        }
-                    }
-                }
-                offset += length + 1;
-                length = 0;
+                t4_process_word(in, eng, data + start, i - start);
+                start = SIZE_MAX;
             }
 
-            mask >>= 1;
-            skip -= 1;
-        } while (mask);
-
-        offset += skip;
+            edges = _blsr_u32(edges);
+        }
     }
 
-    if (length != 0) {
-        // printf("%.*s\n", length, data + offset);
-        const char * w = data + offset;
-            
-        if (qhm_map_try_insert(in, w, length)) {
-            qhm_entry_t * e = qhm_map_get(eng, w, length);
-
-            if (!e) {
-                printf("%.*s\n", length, w);
-            }
-        }
+    if (start != SIZE_MAX) {
+        t4_process_word(in, eng, data + start, data_size - start);
     }
 }
 
@@ -0,0 +1,61 @@
+#include "t4/arena.h"
+
+#include "t4/mem.h"
+
+#include <string.h>
+
+struct t4_arena_chunk {
+    t4_arena_chunk_t * next;
+    size_t used;
+    size_t size;
+    u8 data[];
+};
+
+static t4_arena_chunk_t * t4_arena_chunk_new(const size_t size) {
+    t4_arena_chunk_t * chunk = t4_calloc(1, sizeof(t4_arena_chunk_t) + size);
+    chunk->size = size;
+
+    return chunk;
+}
+
+void * t4_arena_copy(t4_arena_t * self, const void * data, const size_t size) {
+    t4_arena_chunk_t * head = self->chunks;
+
+    if (head == NULL || head->size - head->used < size) {
+        if (size > T4_ARENA_CHUNK_SIZE / 4) {
+            /* Goes behind the head, so what is left of the head can still be used. */
+            t4_arena_chunk_t * own = t4_arena_chunk_new(size);
+            own->used = size;
+
+            if (head == NULL) {
+                self->chunks = own;
+            } else {
+                own->next = head->next;
+                head->next = own;
+            }
+
+            return memcpy(own->data, data, size);
+        }
+
+        head = t4_arena_chunk_new(T4_ARENA_CHUNK_SIZE);
+        head->next = self->chunks;
+        self->chunks = head;
+    }
+
+    void * copy = head->data + head->used;
+    head->used += size;
+
+    return memcpy(copy, data, size);
+}
+
+void t4_arena_free(t4_arena_t * self) {
+    t4_arena_chunk_t * chunk = self->chunks;
+
+    while (chunk != NULL) {
+        t4_arena_chunk_t * next = chunk->next;
+        t4_free(chunk);
+        chunk = next;
+    }
+
+    self->chunks = NULL;
+}
@@ -0,0 +1,607 @@
+#include "t4/common.h"
+#include "t4/stset.h"
+#include "t4/stmap.h"
+#include "t4/stset_sharded.h"
+#include "t4/phf.h"
+#include "t4/stree.h"
+#include "t4/bloom.h"
+#include "t4/rtinfo.h"
+#include "t4/mem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <time.h>
+#include <x86intrin.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * Runs the same workload against every stset backend the CPU supports:
+ *  - build:  insert_unchecked of every dictionary word into t4_stset_new(400000);
+ *  - hit:    exists of every dictionary word;
+ *  - miss:   exists of every dictionary word with its first letter capitalised;
+ *  - input:  try_insert of every token of the input into t4_stset_new(10000);
+ *  - small:  exists of every token of the input against that small set, also in TSC ticks per lookup;
+ *  - batch:  hit and miss again, through t4_stset_exists_batch;
+ *  - count:  t4_stmap_upsert of every token of the input into t4_stmap_new(10000, sizeof(u32)), counting it.
+ *
+ * Then the mean number of groups a hit and a miss probe, and the longest probe, with the dictionary filling a set
+ * to several load factors. Build with -DT4_STSET_LINEAR_PROBING=ON to get the same numbers for linear probing.
+ *
+ * Last, how t4_stset_sharded scales: the dictionary words, the misses and the input tokens all go through
+ * t4_stset_sharded_try_insert, split between 1, 2, 4, ... up to as many threads as there are CPUs (or
+ * T4_BENCH_THREADS), next to a plain single-threaded t4_stset doing the same.
+ *
+ * Then the static dictionaries against the set: build, hit, miss and every input token looked up in a t4_stset,
+ * a t4_phf and a t4_stree, hit and miss again through the batch lookups of those that have them (for the tree with
+ * each batch search the CPU supports), and for the tree the nearest words of every miss, its predecessor and successor.
+ * Each of them again with a t4_bloom of T4_BENCH_BLOOM_BITS bits per word in front, which only lets through some
+ * of the misses; last, the filter alone at a few sizes, and how many of the misses it lets through.
+ *
+ * With dynamic dispatch every supported backend is measured, otherwise just the one fixed at build time.
+ */
+
+#if defined(T4_STSET_IFUNC)
+#   define T4_BENCH_DISPATCH "ifunc"
+#elif defined(T4_STSET_STATIC_BACKEND)
+#   define T4_BENCH_STR_(x) #x
+#   define T4_BENCH_STR(x) T4_BENCH_STR_(x)
+#   define T4_BENCH_DISPATCH "static " T4_BENCH_STR(T4_STSET_STATIC_BACKEND)
+#endif
+
+/* Bits per dictionary word of the filter in front of the dictionaries */
+#define T4_BENCH_BLOOM_BITS 10
+
+typedef struct {
+    char * buf;
+    size_t size;
+} t4_bench_file_t;
+
+typedef struct {
+    t4_stset_key_t * keys;
+    size_t len;
+} t4_bench_keys_t;
+
+static t4_bench_file_t t4_bench_read_file(const char * fp) {
+    FILE * f = fopen(fp, "rb");
+    if (f == NULL) {
+        return (t4_bench_file_t) { .buf = NULL, .size = 0, };
+    }
+
+    t4_bench_file_t res;
+
+    fseek(f, 0l, SEEK_END);
+    res.size = ftell(f);
+    fseek(f, 0l, SEEK_SET);
+
+    res.buf = t4_calloc(res.size + 1, 1);
+
+    const size_t read = fread(res.buf, 1, res.size, f);
+    assert(read == res.size);
+
+    fclose(f);
+
+    return res;
+}
+
+/* Splits buf at every byte for which is_word is false, lowercasing it in place. */
+static t4_bench_keys_t t4_bench_split(char * buf, const size_t size, int (*is_word)(int)) {
+    t4_bench_keys_t res = {
+        .keys = t4_calloc(size / 2 + 1, sizeof(t4_stset_key_t)),
+        .len = 0,
+    };
+
+    char * start = buf;
+    for (size_t i = 0; i <= size; i++) {
+        char * c = buf + i;
+        if (i == size || !is_word(*c)) {
+            if (c != start) {
+                res.keys[res.len++] = (t4_stset_key_t) { .data = start, .size = c - start, };
+            }
+            start = c + 1;
+        } else {
+            *c = tolower(*c);
+        }
+    }
+
+    return res;
+}
+
+static int t4_bench_is_not_nul(const int c) {
+    return c != '\0';
+}
+
+static double t4_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void t4_bench_run(const char * name, const t4_bench_keys_t * dict, const t4_bench_keys_t * misses, const t4_bench_keys_t * words) {
+    u64 found = 0;
+
+    double t0 = t4_bench_now();
+
+    t4_stset_t eng = t4_stset_new(400000);
+    for (size_t i = 0; i < dict->len; i++) {
+        t4_stset_insert_unchecked(&eng, dict->keys[i].data, dict->keys[i].size);
+    }
+
+    double t1 = t4_bench_now();
+
+    for (size_t i = 0; i < dict->len; i++) {
+        found += t4_stset_exists(&eng, dict->keys[i].data, dict->keys[i].size);
+    }
+
+    double t2 = t4_bench_now();
+
+    for (size_t i = 0; i < misses->len; i++) {
+        found += t4_stset_exists(&eng, misses->keys[i].data, misses->keys[i].size);
+    }
+
+    double t3 = t4_bench_now();
+
+    t4_stset_t in = t4_stset_new(10000);
+    for (size_t i = 0; i < words->len; i++) {
+        found += t4_stset_try_insert(&in, words->keys[i].data, words->keys[i].size);
+    }
+
+    double t4 = t4_bench_now();
+    const u64 c0 = __rdtsc();
+
+    for (size_t i = 0; i < words->len; i++) {
+        found += t4_stset_exists(&in, words->keys[i].data, words->keys[i].size);
+    }
+
+    const u64 c1 = __rdtsc();
+    double t5 = t4_bench_now();
+
+    u64 * bitmap = t4_calloc(T4_STSET_BITMAP_WORDS(dict->len), sizeof(u64));
+
+    t4_stset_exists_batch(&eng, dict->keys, dict->len, bitmap);
+    for (size_t i = 0; i < dict->len; i++) {
+        found += t4_stset_bitmap_get(bitmap, i);
+    }
+
+    double t6 = t4_bench_now();
+
+    t4_stset_exists_batch(&eng, misses->keys, misses->len, bitmap);
+    for (size_t i = 0; i < misses->len; i++) {
+        found += t4_stset_bitmap_get(bitmap, i);
+    }
+
+    double t7 = t4_bench_now();
+
+    t4_stmap_t counts = t4_stmap_new(10000, sizeof(u32));
+    for (size_t i = 0; i < words->len; i++) {
+        ++*(u32 *)t4_stmap_upsert(&counts, words->keys[i].data, words->keys[i].size, NULL);
+    }
+
+    double t8 = t4_bench_now();
+
+    /* Every token was counted exactly once. */
+    u64 counted = 0;
+    void * value;
+    for (size_t it = 0; t4_stmap_next(&counts, &it, &value) != NULL;) {
+        counted += *(u32 *)value;
+    }
+    if (counted != words->len) {
+        fprintf(stderr, "%s: counted %lu of %lu tokens\n", name, counted, words->len);
+    }
+
+    t4_stmap_free(&counts);
+    t4_free(bitmap);
+
+    printf("%-14s %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n",
+           name,
+           (t1 - t0) / dict->len,
+           (t2 - t1) / dict->len,
+           (t3 - t2) / misses->len,
+           (t4 - t3) / words->len,
+           (t5 - t4) / words->len,
+           (double)(c1 - c0) / words->len,
+           (t6 - t5) / dict->len,
+           (t7 - t6) / misses->len,
+           (t8 - t7) / words->len);
+
+    /* Keeps the lookups from being optimised out, and doubles as a sanity check. */
+    if (found < dict->len) {
+        fprintf(stderr, "%s: only %lu of %lu lookups succeeded\n", name, found, dict->len);
+    }
+
+    t4_stset_free(&in);
+    t4_stset_free(&eng);
+}
+
+static void t4_bench_probe(const char * name, const t4_bench_keys_t * dict, const t4_bench_keys_t * misses) {
+    static const float load_factors[] = { 0.5f, 0.75f, 0.875f, 0.95f };
+
+    for (size_t lf = 0; lf < sizeof(load_factors) / sizeof(load_factors[0]); lf++) {
+        /* Rounded up to at most dict->len, so there are always enough keys to fill it. */
+        t4_stset_t set = t4_stset_new(dict->len / 2);
+        t4_stset_set_max_load_factor(&set, 1.0f);
+
+        const size_t n = (size_t)(set.capacity * load_factors[lf]);
+        for (size_t i = 0; i < n; i++) {
+            t4_stset_insert_unchecked(&set, dict->keys[i].data, dict->keys[i].size);
+        }
+
+        u64 hit = 0, miss = 0, longest = 0;
+        for (size_t i = 0; i < n; i++) {
+            const size_t len = t4_stset_probe_length(&set, misses->keys[i].data, misses->keys[i].size);
+
+            hit += t4_stset_probe_length(&set, dict->keys[i].data, dict->keys[i].size);
+            miss += len;
+            longest = len > longest ? len : longest;
+        }
+
+        printf("%-14s %12.3f %12.3f %12.3f %12lu\n", name, load_factors[lf], (double)hit / n, (double)miss / n, longest);
+
+        t4_stset_free(&set);
+    }
+}
+
+typedef struct {
+    t4_stset_sharded_t * set;
+    const t4_bench_keys_t * keys;
+    size_t first;
+    size_t step;
+    u64 inserted;
+} t4_bench_thread_t;
+
+static void * t4_bench_thread(void * arg) {
+    t4_bench_thread_t * t = arg;
+
+    /* Strided rather than in blocks, so threads keep racing on the same frequent input tokens. */
+    for (size_t i = t->first; i < t->keys->len; i += t->step) {
+        t->inserted += t4_stset_sharded_try_insert(t->set, t->keys->keys[i].data, t->keys->keys[i].size);
+    }
+
+    return NULL;
+}
+
+static void t4_bench_scaling(const t4_bench_keys_t * dict, const t4_bench_keys_t * misses, const t4_bench_keys_t * words) {
+    t4_bench_keys_t keys = {
+        .keys = t4_calloc(dict->len + misses->len + words->len, sizeof(t4_stset_key_t)),
+        .len = 0,
+    };
+    const t4_bench_keys_t * parts[] = { dict, misses, words };
+    for (size_t p = 0; p < 3; p++) {
+        memcpy(keys.keys + keys.len, parts[p]->keys, parts[p]->len * sizeof(t4_stset_key_t));
+        keys.len += parts[p]->len;
+    }
+
+    const char * env = getenv("T4_BENCH_THREADS");
+    const long cpus = env != NULL ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t max_threads = cpus > 1 ? (size_t)cpus : 1;
+
+    double t0 = t4_bench_now();
+
+    t4_stset_t plain = t4_stset_new(1024);
+    for (size_t i = 0; i < keys.len; i++) {
+        t4_stset_try_insert(&plain, keys.keys[i].data, keys.keys[i].size);
+    }
+
+    const double base = t4_bench_now() - t0;
+    const size_t unique = t4_stset_size(&plain);
+    t4_stset_free(&plain);
+
+    printf("%-14s %12.2f %12s\n", "stset", keys.len / base * 1e3, "-");
+
+    t4_bench_thread_t * threads = t4_calloc(max_threads, sizeof(t4_bench_thread_t));
+    pthread_t * ids = t4_calloc(max_threads, sizeof(pthread_t));
+
+    for (size_t n = 1;; n = n * 2 < max_threads ? n * 2 : max_threads) {
+        /* Small to start with like the plain set, so growing the shards under contention is measured too. */
+        t4_stset_sharded_t set = t4_stset_sharded_new(1024, 64);
+
+        t0 = t4_bench_now();
+
+        for (size_t i = 0; i < n; i++) {
+            threads[i] = (t4_bench_thread_t) { .set = &set, .keys = &keys, .first = i, .step = n, .inserted = 0, };
+            pthread_create(&ids[i], NULL, t4_bench_thread, &threads[i]);
+        }
+
+        u64 inserted = 0;
+        for (size_t i = 0; i < n; i++) {
+            pthread_join(ids[i], NULL);
+            inserted += threads[i].inserted;
+        }
+
+        const double elapsed = t4_bench_now() - t0;
+
+        char name[32];
+        snprintf(name, sizeof(name), "sharded x%lu", n);
+        printf("%-14s %12.2f %12.2f\n", name, keys.len / elapsed * 1e3, base / elapsed);
+
+        /* Every distinct key must have been reported as new by exactly one thread. */
+        if (inserted != unique || t4_stset_sharded_size(&set) != unique) {
+            fprintf(stderr, "%s: %lu inserted, %lu in the set, expected %lu\n", name, inserted, t4_stset_sharded_size(&set), unique);
+        }
+
+        t4_stset_sharded_free(&set);
+
+        if (n == max_threads) {
+            break;
+        }
+    }
+
+    t4_free(ids);
+    t4_free(threads);
+    t4_free(keys.keys);
+}
+
+/* Looks up every key in whichever of set, phf and tree is not NULL, after bloom if any, returning how many were found. */
+static u64 t4_bench_lookup(const t4_bloom_t * bloom, const t4_stset_t * set, const t4_phf_t * phf, const t4_stree_t * tree,
+                           const t4_bench_keys_t * keys) {
+    u64 found = 0;
+
+    for (size_t i = 0; i < keys->len; i++) {
+        const t4_stset_key_t * k = keys->keys + i;
+
+        if (bloom != NULL && !t4_bloom_may_contain(bloom, k->data, k->size)) {
+            continue;
+        } else if (set != NULL) {
+            found += t4_stset_exists(set, k->data, k->size);
+        } else if (phf != NULL) {
+            found += t4_phf_exists(phf, k->data, k->size);
+        } else {
+            found += t4_stree_exists(tree, k->data, k->size);
+        }
+    }
+
+    return found;
+}
+
+static void t4_bench_dict(const char * name, const t4_bloom_t * bloom, const t4_stset_t * set, const t4_phf_t * phf, const t4_stree_t * tree,
+                          const double build, const t4_bench_keys_t * dict, const t4_bench_keys_t * misses, const t4_bench_keys_t * words) {
+    double t0 = t4_bench_now();
+    const u64 hits = t4_bench_lookup(bloom, set, phf, tree, dict);
+    double t1 = t4_bench_now();
+    const u64 false_hits = t4_bench_lookup(bloom, set, phf, tree, misses);
+    double t2 = t4_bench_now();
+    u64 found = t4_bench_lookup(bloom, set, phf, tree, words);
+    double t3 = t4_bench_now();
+
+    char batch_hit[16] = "-";
+    char batch_miss[16] = "-";
+    char nearest[16] = "-";
+    u64 batch_hits = dict->len;
+    u64 batch_false_hits = 0;
+
+    if (phf == NULL && bloom == NULL) {
+        u64 * bitmap = t4_calloc(T4_STSET_BITMAP_WORDS(dict->len), sizeof(u64));
+        const t4_bench_keys_t * parts[] = { dict, misses };
+        char * columns[] = { batch_hit, batch_miss };
+        u64 * counts[] = { &batch_hits, &batch_false_hits };
+
+        for (size_t p = 0; p < 2; p++) {
+            const double start = t4_bench_now();
+
+            if (set != NULL) {
+                t4_stset_exists_batch(set, parts[p]->keys, parts[p]->len, bitmap);
+            } else {
+                t4_stree_exists_batch(tree, parts[p]->keys, parts[p]->len, bitmap);
+            }
+
+            *counts[p] = 0;
+            for (size_t i = 0; i < parts[p]->len; i++) {
+                *counts[p] += t4_stset_bitmap_get(bitmap, i);
+            }
+
+            snprintf(columns[p], 16, "%.2f", (t4_bench_now() - start) / parts[p]->len);
+        }
+
+        t4_free(bitmap);
+    }
+
+    if (tree != NULL && bloom == NULL) {
+        const double start = t4_bench_now();
+
+        for (size_t i = 0; i < misses->len; i++) {
+            size_t index;
+            found += t4_stree_predecessor(tree, misses->keys[i].data, misses->keys[i].size, &index);
+            found += t4_stree_successor(tree, misses->keys[i].data, misses->keys[i].size, &index);
+        }
+
+        snprintf(nearest, sizeof(nearest), "%.2f", (t4_bench_now() - start) / misses->len);
+    }
+
+    printf("%-14s %12.2f %12.2f %12.2f %12.2f %12s %12s %12s\n", name, build / dict->len, (t1 - t0) / dict->len,
+           (t2 - t1) / misses->len, (t3 - t2) / words->len, batch_hit, batch_miss, nearest);
+
+    /* found keeps the input lookups from being optimised out. */
+    if (hits != dict->len || false_hits != 0 || batch_hits != dict->len || batch_false_hits != 0 || found > words->len + 2 * misses->len) {
+        fprintf(stderr, "%s: %lu and %lu of %lu hits, %lu and %lu of the misses found\n", name, hits, batch_hits, dict->len,
+                false_hits, batch_false_hits);
+    }
+}
+
+static void t4_bench_dicts(const t4_bench_keys_t * dict, const t4_bench_keys_t * misses, const t4_bench_keys_t * words) {
+    double t0 = t4_bench_now();
+
+    t4_stset_t set = t4_stset_new(400000);
+    for (size_t i = 0; i < dict->len; i++) {
+        t4_stset_insert_unchecked(&set, dict->keys[i].data, dict->keys[i].size);
+    }
+
+    double t1 = t4_bench_now();
+
+    size_t phf_size;
+    u8 * phf_image = t4_phf_build(dict->keys, dict->len, &phf_size);
+
+    double t2 = t4_bench_now();
+
+    size_t tree_size;
+    u8 * tree_image = t4_stree_build(dict->keys, dict->len, &tree_size);
+
+    double t3 = t4_bench_now();
+
+    t4_phf_t phf;
+    t4_stree_t tree;
+    if (phf_image == NULL || tree_image == NULL || !t4_phf_open(&phf, phf_image, phf_size) || !t4_stree_open(&tree, tree_image, tree_size)) {
+        fprintf(stderr, "Failed to build the static dictionaries, are there duplicate words?\n");
+    } else {
+        t4_bench_dict("stset", NULL, &set, NULL, NULL, t1 - t0, dict, misses, words);
+        t4_bench_dict("phf", NULL, NULL, &phf, NULL, t2 - t1, dict, misses, words);
+
+        tree.search = t4_internal_stree_search_scalar;
+        t4_bench_dict("tree scalar", NULL, NULL, NULL, &tree, t3 - t2, dict, misses, words);
+
+        if (t4_get_cpu_features().avx2) {
+            tree.search = t4_internal_stree_search_avx2;
+            t4_bench_dict("tree avx2", NULL, NULL, NULL, &tree, t3 - t2, dict, misses, words);
+        }
+
+        const double t4 = t4_bench_now();
+
+        t4_bloom_t bloom = t4_bloom_new(dict->len, T4_BENCH_BLOOM_BITS, false);
+        for (size_t i = 0; i < dict->len; i++) {
+            t4_bloom_insert(&bloom, dict->keys[i].data, dict->keys[i].size);
+        }
+
+        const double filter = t4_bench_now() - t4;
+
+        t4_bench_dict("bloom+stset", &bloom, &set, NULL, NULL, t1 - t0 + filter, dict, misses, words);
+        t4_bench_dict("bloom+phf", &bloom, NULL, &phf, NULL, t2 - t1 + filter, dict, misses, words);
+        t4_bench_dict("bloom+tree", &bloom, NULL, NULL, &tree, t3 - t2 + filter, dict, misses, words);
+
+        t4_bloom_free(&bloom);
+    }
+
+    t4_free(tree_image);
+    t4_free(phf_image);
+    t4_stset_free(&set);
+}
+
+static void t4_bench_bloom(const t4_bench_keys_t * dict, const t4_bench_keys_t * misses) {
+    static const size_t bits[] = { 8, 10, 12, 16 };
+
+    for (size_t b = 0; b < sizeof(bits) / sizeof(bits[0]); b++) {
+        for (int avx2 = 0; avx2 <= t4_get_cpu_features().avx2; avx2++) {
+            double t0 = t4_bench_now();
+
+            t4_bloom_t bloom = t4_bloom_new(dict->len, (double)bits[b], false);
+            bloom.find = avx2 ? t4_internal_bloom_find_avx2 : t4_internal_bloom_find_scalar;
+
+            for (size_t i = 0; i < dict->len; i++) {
+                t4_bloom_insert(&bloom, dict->keys[i].data, dict->keys[i].size);
+            }
+
+            double t1 = t4_bench_now();
+
+            u64 hits = 0;
+            for (size_t i = 0; i < dict->len; i++) {
+                hits += t4_bloom_may_contain(&bloom, dict->keys[i].data, dict->keys[i].size);
+            }
+
+            double t2 = t4_bench_now();
+
+            t4_bloom_stats_t stats = { .lookups = misses->len, .rejected = 0, .false_positives = 0, };
+            for (size_t i = 0; i < misses->len; i++) {
+                stats.false_positives += t4_bloom_may_contain(&bloom, misses->keys[i].data, misses->keys[i].size);
+            }
+            stats.rejected = stats.lookups - stats.false_positives;
+
+            double t3 = t4_bench_now();
+
+            char name[32];
+            snprintf(name, sizeof(name), "bloom %s", avx2 ? "avx2" : "scalar");
+            printf("%-14s %12lu %12lu %12.2f %12.2f %12.2f %12.3f\n", name, bits[b], bloom.num_blocks * sizeof(t4_bloom_block_t) / 1024,
+                   (t1 - t0) / dict->len, (t2 - t1) / dict->len, (t3 - t2) / misses->len, t4_bloom_false_positive_rate(&stats) * 100.0);
+
+            /* A Bloom filter never misses a key that is in it. */
+            if (hits != dict->len) {
+                fprintf(stderr, "%s: only %lu of %lu hits\n", name, hits, dict->len);
+            }
+
+            t4_bloom_free(&bloom);
+        }
+    }
+}
+
+int main(const int argc, const char * argv[]) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage: %s [filename] [dictionary (default ./sorted.bin)]\n", argv[0]);
+        return 1;
+    }
+
+    const char * dict_path = argc == 3 ? argv[2] : "./sorted.bin";
+
+    t4_bench_file_t f = t4_bench_read_file(argv[1]);
+    t4_bench_file_t ef = t4_bench_read_file(dict_path);
+    if (f.buf == NULL || ef.buf == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", f.buf == NULL ? argv[1] : dict_path, strerror(errno));
+        return 1;
+    }
+
+    t4_bench_keys_t words = t4_bench_split(f.buf, f.size, isalpha);
+    t4_bench_keys_t dict = t4_bench_split(ef.buf, ef.size, t4_bench_is_not_nul);
+
+    /* The dictionary is all lowercase, so capitalising a copy of it gives a set of keys that always miss. */
+    char * miss_buf = t4_calloc(ef.size + 1, 1);
+    memcpy(miss_buf, ef.buf, ef.size);
+
+    t4_bench_keys_t misses = {
+        .keys = t4_calloc(dict.len, sizeof(t4_stset_key_t)),
+        .len = dict.len,
+    };
+    for (size_t i = 0; i < dict.len; i++) {
+        char * data = miss_buf + ((char *)dict.keys[i].data - ef.buf);
+        data[0] = toupper(data[0]);
+
+        misses.keys[i] = (t4_stset_key_t) { .data = data, .size = dict.keys[i].size, };
+    }
+
+    printf("%-14s %12s %12s %12s %12s %12s %12s %12s %12s %12s\n",
+           "isa", "build ns/op", "hit ns/op", "miss ns/op", "input ns/op", "small ns/op", "small tsc/op",
+           "bhit ns/op", "bmiss ns/op", "count ns/op");
+
+#if defined(T4_BENCH_DISPATCH)
+    t4_bench_run(T4_BENCH_DISPATCH, &dict, &misses, &words);
+#else
+    for (enum t4_stset_isa isa = 0; isa < T4_STSET_ISA_COUNT; isa++) {
+        if (t4_internal_stset_init_isa(isa)) {
+            t4_bench_run(t4_internal_stset_isa_name(isa), &dict, &misses, &words);
+        }
+    }
+#endif
+
+    printf("\n%-14s %12s %12s %12s %12s\n", "isa", "load factor", "hit groups", "miss groups", "max groups");
+
+#if defined(T4_BENCH_DISPATCH)
+    t4_bench_probe(T4_BENCH_DISPATCH, &dict, &misses);
+#else
+    for (enum t4_stset_isa isa = 0; isa < T4_STSET_ISA_COUNT; isa++) {
+        if (t4_internal_stset_init_isa(isa)) {
+            t4_bench_probe(t4_internal_stset_isa_name(isa), &dict, &misses);
+        }
+    }
+#endif
+
+    printf("\n%-14s %12s %12s\n", "threads", "Mops/s", "speedup");
+
+#if !defined(T4_BENCH_DISPATCH)
+    t4_internal_stset_init();
+#endif
+    t4_bench_scaling(&dict, &misses, &words);
+
+    printf("\n%-14s %12s %12s %12s %12s %12s %12s %12s\n", "dictionary", "build ns/op", "hit ns/op", "miss ns/op", "input ns/op",
+           "bhit ns/op", "bmiss ns/op", "nearest ns/op");
+    t4_bench_dicts(&dict, &misses, &words);
+
+    printf("\n%-14s %12s %12s %12s %12s %12s %12s\n", "filter", "bits/word", "KiB", "build ns/op", "hit ns/op", "miss ns/op", "fp rate %");
+    t4_bench_bloom(&dict, &misses);
+
+    t4_free(misses.keys);
+    t4_free(miss_buf);
+    t4_free(dict.keys);
+    t4_free(words.keys);
+    t4_free(ef.buf);
+    t4_free(f.buf);
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "t4/bloom.h"
+
+#include "t4/mem.h"
+#include "t4/rtinfo.h"
+
+t4_bloom_t t4_bloom_new(const size_t num_keys, const double bits_per_key, const bool fold_case) {
+    const size_t bits = (size_t)(num_keys * bits_per_key);
+    /* Whole cache lines, as aligned_alloc wants */
+    const size_t num_blocks = T4_ALIGN_UP(bits / (T4_BLOOM_BLOCK_WORDS * 32) + 1, 64 / sizeof(t4_bloom_block_t));
+
+    t4_bloom_t res = {
+        .num_blocks = num_blocks,
+        .blocks = t4_calloc_aligned(num_blocks * sizeof(t4_bloom_block_t), 64),
+        .fold_case = fold_case,
+        .find = t4_internal_bloom_find_scalar,
+    };
+
+#if defined(__AVX2__)
+    res.find = t4_internal_bloom_find_avx2;
+#else
+    const t4_cpu_features_t features = t4_get_cpu_features();
+    if (features.avx2) {
+        res.find = t4_internal_bloom_find_avx2;
+    }
+#endif
+
+    return res;
+}
+
+void t4_bloom_free(t4_bloom_t * self) {
+    t4_free_aligned(self->blocks);
+    self->num_blocks = 0;
+}
+
+bool t4_internal_bloom_find_scalar(const t4_bloom_t * self, const u64 hash) {
+    const u32 * words = self->blocks[t4_bloom_block(self, hash)].words;
+
+    u32 missing = 0;
+    for (size_t i = 0; i < T4_BLOOM_BLOCK_WORDS; i++) {
+        missing |= ~words[i] & (1u << (((u32)hash * t4_bloom_salts[i]) >> 27));
+    }
+
+    return missing == 0;
+}
@@ -0,0 +1,1216 @@
+#include "t4/common.h"
+#include "t4/tokenize.h"
+#include "t4/phf.h"
+#include "t4/stree.h"
+#include "t4/stset.h"
+#include "t4/stmap.h"
+#include "t4/stset_sharded.h"
+#include "t4/rtinfo.h"
+#include "t4/mem.h"
+#include "t4/wyhash.h"
+#include "t4/internal/ascii_fold.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*
+ * Checks the parts of t4 that have a fast path and a plain one, or that are easy to get subtly wrong, against
+ * slower references on random inputs, and prints the first few differences. Exits with 1 if there were any.
+ *  - tokenize: every backend the CPU supports against the scalar one, in batches of random sizes; read-only
+ *    tokenizing plus t4_tokenize_fold against tokenizing in place; inputs cut at t4_tokenize_split_point against
+ *    the whole; and a few inputs whose words are known.
+ *  - phf: images of random key sets of many sizes, down to none, against the keys themselves: every key lands in a
+ *    slot of its own that holds it, the remap only points at slots of keys, and exists and exists_folded agree with
+ *    a binary search of the keys for them, case flipped copies of them and random other keys.
+ *  - stree: trees of random key sets, many of them sharing their first 8 bytes or differing only in case, against
+ *    a plain binary search of the keys sorted by a plain compare: the order itself, lower_bound, predecessor,
+ *    successor, exists and exists_folded, and the batch lookups with every search the CPU supports.
+ *  - stset: on every backend the CPU supports, random inserts, lookups and removes of keys of a fixed set against
+ *    a plain array of which of them are in: single, with a hash, batched and fused with a second set, with and
+ *    without fold_case, owning or not, at several load factors, in phases of mostly removing so tombstones pile up.
+ *    The walk must stay in insertion order and the set must rebuild in place rather than grow. A t4_stmap keeps
+ *    counts against a plain array, and threads insert the same keys into a t4_stset_sharded, each new just once.
+ *
+ * The inputs are the same on every run, T4_CHECK_SEED sets another seed.
+ */
+
+#if defined(T4_STSET_IFUNC)
+#   define T4_CHECK_DISPATCH "ifunc"
+#elif defined(T4_STSET_STATIC_BACKEND)
+#   define T4_CHECK_STR_(x) #x
+#   define T4_CHECK_STR(x) T4_CHECK_STR_(x)
+#   define T4_CHECK_DISPATCH T4_CHECK_STR(T4_STSET_STATIC_BACKEND)
+#endif
+
+/* Differences printed per check before it only counts them */
+#define T4_CHECK_MAX_REPORTS 5
+
+typedef struct {
+    const char * name;
+    size_t cases;
+    size_t failures;
+} t4_check_t;
+
+static bool t4_check(t4_check_t * self, const bool ok, const char * what, const u64 seed) {
+    if (!ok && self->failures++ < T4_CHECK_MAX_REPORTS) {
+        fprintf(stderr, "%s: %s (case %lu, seed %lu)\n", self->name, what, self->cases, seed);
+    }
+
+    return ok;
+}
+
+static bool t4_check_done(const t4_check_t * self) {
+    printf("%-14s %10lu cases %10lu failures\n", self->name, self->cases, self->failures);
+    return self->failures == 0;
+}
+
+/* Characters the random inputs are made of, valid or not */
+static const char * t4_check_pieces[] = {
+    " ", " ", ".", ",\n", "'", "-", "0", "_", "\t",
+    "\xc3\xa9", "\xc3\x89", "\xc3\x9f", "\xce\xa3", "\xcf\x82", "\xd0\x96", "\xd0\xb6", "\xd7\x90",
+    "\xcc\x81", "\xe4\xb8\xad", "\xe2\x84\xaa", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xf0\x90\x90\x80",
+    "\x80", "\xbf", "\xc0\xaf", "\xc3", "\xe2\x82", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xff",
+};
+
+/* Random text of up to max_size bytes, mostly ASCII letters; one in every ascii_every pieces is anything else. */
+static size_t t4_check_text(u64 * rng, char * buf, const size_t max_size, const u64 ascii_every) {
+    size_t size = 0;
+    const size_t target = wyrand(rng) % (max_size + 1);
+
+    while (size < target) {
+        const char * piece;
+        char letter[2] = { 0 };
+
+        if (wyrand(rng) % ascii_every != 0) {
+            letter[0] = (char)((wyrand(rng) % 2 ? 'a' : 'A') + wyrand(rng) % 26);
+            piece = letter;
+        } else {
+            piece = t4_check_pieces[wyrand(rng) % (sizeof(t4_check_pieces) / sizeof(t4_check_pieces[0]))];
+        }
+
+        const size_t len = strlen(piece);
+        if (size + len > max_size) {
+            break;
+        }
+
+        memcpy(buf + size, piece, len);
+        size += len;
+    }
+
+    return size;
+}
+
+/* Drains a tokenizer with next in batches of random sizes, returning the number of tokens. */
+static size_t t4_check_drain(t4_tokenizer_t * tokenizer, const t4_tokenize_fn next, u64 * rng, t4_token_t * tokens) {
+    tokenizer->next = next;
+
+    size_t n = 0;
+    for (;;) {
+        const size_t batch = 1 + wyrand(rng) % (2 * T4_TOKENIZE_BLOCK_TOKENS + 8);
+        const size_t got = t4_tokenize(tokenizer, tokens + n, batch);
+
+        if (got == 0) {
+            return n;
+        }
+
+        n += got;
+    }
+}
+
+static bool t4_check_same_tokens(const t4_token_t * a, const size_t a_len, const t4_token_t * b, const size_t b_len) {
+    if (a_len != b_len) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a_len; i++) {
+        if (a[i].offset != b[i].offset || a[i].size != b[i].size) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Inputs whose words are known, folded, and separated by spaces. */
+static void t4_check_tokenize_known(t4_check_t * check, const t4_tokenize_fn next) {
+    static const char * cases[][2] = {
+        { "Hello, World!", "hello world" },
+        { "Caf\xc3\xa9 NA\xc3\x8fVE", "caf\xc3\xa9 na\xc3\xafve" },
+        { "\xce\x95\xce\xbb\xce\xbb\xce\xac\xce\xb4\xce\xb1 \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0",
+          "\xce\xb5\xce\xbb\xce\xbb\xce\xac\xce\xb4\xce\xb1 \xd0\xbc\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0" },
+        /* A combining mark stays in the word */
+        { "Xe\xcc\x81Y", "xe\xcc\x81y" },
+        /* KELVIN SIGN folds to a shorter "k", so it is left as it is */
+        { "5\xe2\x84\xaa", "\xe2\x84\xaa" },
+        /* Invalid bytes separate words, and a truncated character does not swallow the letter after it */
+        { "ab\x80" "Cd\xc3" "e\xe2\x82\xacZ\xed\xa0\x80q", "ab cd e z q" },
+        /* Whole blocks of ASCII, with words across their ends */
+        { "Only ASCII words, enough of them to fill a few blocks of thirty-two bytes",
+          "only ascii words enough of them to fill a few blocks of thirty two bytes" },
+    };
+
+    u64 rng = 0;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++, check->cases++) {
+        char buf[128];
+        char words[128];
+        t4_token_t tokens[64];
+
+        const size_t size = strlen(cases[c][0]);
+        memcpy(buf, cases[c][0], size);
+
+        t4_tokenizer_t tokenizer = t4_tokenizer_new(buf, size);
+        const size_t n = t4_check_drain(&tokenizer, next, &rng, tokens);
+
+        size_t len = 0;
+        for (size_t i = 0; i < n; i++) {
+            memcpy(words + len, buf + tokens[i].offset, tokens[i].size);
+            len += tokens[i].size;
+            words[len++] = ' ';
+        }
+        len -= len != 0;
+
+        t4_check(check, len == strlen(cases[c][1]) && memcmp(words, cases[c][1], len) == 0, "known words differ", c);
+    }
+}
+
+/* Random keys of up to max_size bytes: mostly letters of either case, sometimes a digit or a byte past ASCII. */
+static size_t t4_check_key(u64 * rng, u8 * buf, const size_t max_size) {
+    const size_t size = 1 + wyrand(rng) % max_size;
+
+    for (size_t i = 0; i < size; i++) {
+        const u64 r = wyrand(rng);
+        buf[i] = r % 16 == 0 ? (u8)('0' + (r >> 8) % 10) : r % 16 == 1 ? (u8)(0x80 + (r >> 8) % 0x7f) : (u8)((r & 0x100 ? 'a' : 'A') + (r >> 16) % 26);
+    }
+
+    return size;
+}
+
+/* Orders keys by their bytes with ASCII case folded, then by length. */
+static int t4_check_compare_folded(const void * a, const void * b) {
+    const t4_stset_key_t * p = a;
+    const t4_stset_key_t * q = b;
+    const size_t n = p->size < q->size ? p->size : q->size;
+
+    for (size_t i = 0; i < n; i++) {
+        const u8 x = t4_ascii_fold(((const u8 *)p->data)[i]);
+        const u8 y = t4_ascii_fold(((const u8 *)q->data)[i]);
+
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+
+    return (p->size > q->size) - (p->size < q->size);
+}
+
+typedef struct {
+    u8 * buf;
+    t4_stset_key_t * keys;
+    size_t len;
+} t4_check_keys_t;
+
+/* n random keys, none equal to another with ASCII case ignored, sorted as by t4_check_compare_folded. */
+static t4_check_keys_t t4_check_keys(u64 * rng, const size_t n, const size_t max_size) {
+    t4_check_keys_t res = {
+        .buf = t4_calloc(n * max_size + 1, 1),
+        .keys = t4_calloc(n + 1, sizeof(t4_stset_key_t)),
+        .len = n,
+    };
+
+    for (size_t i = 0; i < n; i++) {
+        u8 * data = res.buf + i * max_size;
+        res.keys[i] = (t4_stset_key_t) { .data = data, .size = t4_check_key(rng, data, max_size), };
+    }
+
+    qsort(res.keys, n, sizeof(t4_stset_key_t), t4_check_compare_folded);
+
+    res.len = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (res.len == 0 || t4_check_compare_folded(res.keys + res.len - 1, res.keys + i) != 0) {
+            res.keys[res.len++] = res.keys[i];
+        }
+    }
+
+    return res;
+}
+
+static void t4_check_keys_free(t4_check_keys_t * self) {
+    t4_free(self->keys);
+    t4_free(self->buf);
+}
+
+/* The key of keys equal to data with ASCII case ignored, NULL if none. */
+static const t4_stset_key_t * t4_check_find_folded(const t4_check_keys_t * keys, const void * data, const size_t size) {
+    const t4_stset_key_t key = { .data = (void *)data, .size = size, };
+
+    return bsearch(&key, keys->keys, keys->len, sizeof(t4_stset_key_t), t4_check_compare_folded);
+}
+
+/* Flips the case of some of the ASCII letters of a copy of key, into buf. */
+static void t4_check_flip_case(u64 * rng, const t4_stset_key_t * key, u8 * buf) {
+    memcpy(buf, key->data, key->size);
+
+    for (size_t i = 0; i < key->size; i++) {
+        if (t4_is_ascii_letter((char)buf[i]) && wyrand(rng) % 3 == 0) {
+            buf[i] ^= 0x20;
+        }
+    }
+}
+
+static bool t4_check_tokenize(const u64 seed) {
+    t4_check_t check = { .name = "tokenize", .cases = 0, .failures = 0, };
+
+    const t4_cpu_features_t features = t4_get_cpu_features();
+    const bool avx2 = features.avx2 && features.bmi1;
+
+    t4_check_tokenize_known(&check, t4_internal_tokenize_scalar);
+    if (avx2) {
+        t4_check_tokenize_known(&check, t4_internal_tokenize_avx2);
+    }
+
+    enum { max_size = 512 };
+    char text[max_size];
+    char buf[max_size];
+    char other[max_size];
+    char word[max_size];
+    t4_token_t tokens[max_size + 1];
+    t4_token_t other_tokens[max_size + 1];
+
+    static const u64 ascii_every[] = { 1000000, 40, 3 };
+
+    for (size_t c = 0; c < 20000; c++, check.cases++) {
+        u64 rng = seed + c;
+        const size_t size = t4_check_text(&rng, text, max_size, ascii_every[c % 3]);
+
+        memcpy(buf, text, size);
+        t4_tokenizer_t tokenizer = t4_tokenizer_new(buf, size);
+        const size_t n = t4_check_drain(&tokenizer, t4_internal_tokenize_scalar, &rng, tokens);
+
+        if (avx2) {
+            memcpy(other, text, size);
+            tokenizer = t4_tokenizer_new(other, size);
+            const size_t m = t4_check_drain(&tokenizer, t4_internal_tokenize_avx2, &rng, other_tokens);
+
+            t4_check(&check, t4_check_same_tokens(tokens, n, other_tokens, m), "avx2 tokens differ from scalar", seed + c);
+            t4_check(&check, memcmp(buf, other, size) == 0, "avx2 folds differently from scalar", seed + c);
+        }
+
+        /* Read-only: the same words, the text left alone, and t4_tokenize_fold of each word as folded in place */
+        memcpy(other, text, size);
+        tokenizer = t4_tokenizer_new_readonly(other, size);
+        const size_t m = t4_check_drain(&tokenizer, avx2 ? t4_internal_tokenize_avx2 : t4_internal_tokenize_scalar, &rng, other_tokens);
+
+        t4_check(&check, t4_check_same_tokens(tokens, n, other_tokens, m), "read-only tokens differ", seed + c);
+        t4_check(&check, memcmp(text, other, size) == 0, "read-only tokenizer wrote to the text", seed + c);
+
+        for (size_t i = 0; i < n && i < m; i++) {
+            memcpy(word, other + other_tokens[i].offset, other_tokens[i].size);
+            t4_tokenize_fold(word, other_tokens[i].size);
+
+            if (!t4_check(&check, memcmp(word, buf + tokens[i].offset, tokens[i].size) == 0, "t4_tokenize_fold differs", seed + c)) {
+                break;
+            }
+        }
+
+        /* Cut where -j would, each piece on its own */
+        const size_t cut = t4_tokenize_split_point(text, size, size != 0 ? wyrand(&rng) % size : 0);
+
+        memcpy(other, text, size);
+        tokenizer = t4_tokenizer_new(other, cut);
+        size_t k = t4_check_drain(&tokenizer, t4_internal_tokenize_scalar, &rng, other_tokens);
+
+        tokenizer = t4_tokenizer_new(other + cut, size - cut);
+        const size_t first = k;
+        k += t4_check_drain(&tokenizer, t4_internal_tokenize_scalar, &rng, other_tokens + k);
+        for (size_t i = first; i < k; i++) {
+            other_tokens[i].offset += cut;
+        }
+
+        t4_check(&check, t4_check_same_tokens(tokens, n, other_tokens, k), "tokens of the pieces differ", seed + c);
+    }
+
+    return t4_check_done(&check);
+}
+
+static void t4_check_phf_keys(t4_check_t * check, const t4_check_keys_t * keys, u64 * rng, const u64 seed) {
+    size_t size;
+    u8 * image = t4_phf_build(keys->keys, keys->len, &size);
+    if (!t4_check(check, image != NULL, "build failed", seed)) {
+        return;
+    }
+
+    t4_phf_t phf;
+    if (!t4_check(check, t4_phf_open(&phf, image, size) && phf.num_keys == keys->len, "open failed", seed)) {
+        t4_free(image);
+        return;
+    }
+
+    for (size_t i = 0; i < phf.num_slots - phf.num_keys; i++) {
+        if (!t4_check(check, phf.remap[i] < phf.num_keys, "remap points past the keys", seed)) {
+            break;
+        }
+    }
+
+    u64 * taken = t4_calloc(T4_STSET_BITMAP_WORDS(phf.num_keys) + 1, sizeof(u64));
+    u8 flipped[64];
+
+    for (size_t i = 0; i < keys->len; i++) {
+        const t4_stset_key_t * key = keys->keys + i;
+
+        const size_t slot = t4_phf_slot(&phf, t4_phf_hash(&phf, key->data, key->size));
+        const bool own = slot < phf.num_keys && !t4_stset_bitmap_get(taken, slot);
+        if (!t4_check(check, own, "two keys share a slot", seed)) {
+            break;
+        }
+        taken[slot / 64] |= 1llu << (slot % 64);
+
+        const size_t begin = phf.offsets[slot];
+        const bool holds = phf.offsets[slot + 1] - begin == key->size && memcmp(phf.keys + begin, key->data, key->size) == 0;
+        t4_check(check, holds, "a slot holds another key", seed);
+        t4_check(check, t4_phf_exists(&phf, key->data, key->size), "a key is missing", seed);
+
+        t4_check_flip_case(rng, key, flipped);
+        const bool same = memcmp(flipped, key->data, key->size) == 0;
+        t4_check(check, t4_phf_exists_folded(&phf, flipped, key->size), "a key with its case flipped is missing folded", seed);
+        t4_check(check, t4_phf_exists(&phf, flipped, key->size) == same, "a key with its case flipped is found", seed);
+    }
+
+    for (size_t i = 0; i < 2 * keys->len + 100; i++) {
+        const size_t n = t4_check_key(rng, flipped, 8);
+        const t4_stset_key_t * found = t4_check_find_folded(keys, flipped, n);
+        const bool exact = found != NULL && memcmp(found->data, flipped, n) == 0;
+
+        t4_check(check, t4_phf_exists_folded(&phf, flipped, n) == (found != NULL), "exists_folded of another key is wrong", seed);
+        t4_check(check, t4_phf_exists(&phf, flipped, n) == exact, "exists of another key is wrong", seed);
+    }
+
+    t4_free(taken);
+    t4_free(image);
+}
+
+static bool t4_check_phf(const u64 seed) {
+    t4_check_t check = { .name = "phf", .cases = 0, .failures = 0, };
+
+    static const size_t sizes[] = { 0, 1, 2, 3, 7, 64, 100, 1000, 5000, 50000 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t r = 0; r < 8; r++, check.cases++) {
+            u64 rng = seed + s * 8 + r;
+
+            /* Short keys so the random others hit some of them too */
+            t4_check_keys_t keys = t4_check_keys(&rng, sizes[s], r % 2 ? 4 : 24);
+            t4_check_phf_keys(&check, &keys, &rng, seed + s * 8 + r);
+            t4_check_keys_free(&keys);
+        }
+    }
+
+    return t4_check_done(&check);
+}
+
+/* Orders keys as t4_stree_compare should: folded bytes, unsigned, then length, then the bytes themselves. */
+static int t4_check_compare_tree(const void * a, const void * b) {
+    const t4_stset_key_t * p = a;
+    const t4_stset_key_t * q = b;
+
+    const int folded = t4_check_compare_folded(a, b);
+    if (folded != 0 || p->size == 0) {
+        return folded;
+    }
+
+    const int res = memcmp(p->data, q->data, p->size);
+    return (res > 0) - (res < 0);
+}
+
+/* Keys for a tree: a few stems of 8 bytes and more, so many keys share their prefix, or short random ones. */
+static size_t t4_check_tree_key(u64 * rng, u8 * buf) {
+    static const char * stems[] = { "", "a", "ab", "counter", "counterf", "counterfeit", "counterfeitinG", "\x80\x81\x82\x83\x84\x85\x86\x87" };
+
+    const char * stem = stems[wyrand(rng) % (sizeof(stems) / sizeof(stems[0]))];
+    size_t size = strlen(stem);
+    memcpy(buf, stem, size);
+
+    const size_t tail = wyrand(rng) % 4;
+    size += tail != 0 ? t4_check_key(rng, buf + size, tail) : 0;
+
+    /* Some differ from another key only in case */
+    for (size_t i = 0; i < size; i++) {
+        if (t4_is_ascii_letter((char)buf[i]) && wyrand(rng) % 8 == 0) {
+            buf[i] ^= 0x20;
+        }
+    }
+
+    return size;
+}
+
+/* The first of the sorted keys not before key under compare, keys->len if none. */
+static size_t t4_check_lower_bound(const t4_check_keys_t * keys, const t4_stset_key_t * key, int (*compare)(const void *, const void *)) {
+    size_t lo = 0;
+    size_t hi = keys->len;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (compare(keys->keys + mid, key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static void t4_check_stree_keys(t4_check_t * check, const t4_check_keys_t * keys, u64 * rng, const u64 seed) {
+    size_t size;
+    u8 * image = t4_stree_build(keys->keys, keys->len, &size);
+    if (!t4_check(check, image != NULL, "build failed", seed)) {
+        return;
+    }
+
+    t4_stree_t tree;
+    if (!t4_check(check, t4_stree_open(&tree, image, size) && t4_stree_size(&tree) == keys->len, "open failed", seed)) {
+        t4_free(image);
+        return;
+    }
+
+    for (size_t i = 0; i < keys->len; i++) {
+        t4_stset_key_t key;
+        key.data = (void *)t4_stree_key(&tree, i, &key.size);
+
+        if (!t4_check(check, t4_check_compare_tree(&key, keys->keys + i) == 0, "keys are out of order", seed)) {
+            break;
+        }
+    }
+
+    /* Queries: the keys, case flipped or cut short copies of them, and random others */
+    const size_t num_queries = 4 * keys->len + 100;
+    t4_check_keys_t queries = {
+        .buf = t4_calloc(num_queries * 32, 1),
+        .keys = t4_calloc(num_queries, sizeof(t4_stset_key_t)),
+        .len = num_queries,
+    };
+
+    for (size_t i = 0; i < num_queries; i++) {
+        u8 * data = queries.buf + i * 32;
+        const t4_stset_key_t * key = keys->len != 0 ? keys->keys + wyrand(rng) % keys->len : NULL;
+        size_t n;
+
+        switch (key != NULL ? i % 4 : 3) {
+        case 0:
+            memcpy(data, key->data, key->size);
+            n = key->size;
+            break;
+        case 1:
+            t4_check_flip_case(rng, key, data);
+            n = key->size;
+            break;
+        case 2:
+            memcpy(data, key->data, key->size);
+            n = key->size - (key->size != 0);
+            break;
+        default:
+            n = t4_check_tree_key(rng, data);
+            break;
+        }
+
+        queries.keys[i] = (t4_stset_key_t) { .data = data, .size = n, };
+    }
+
+    for (size_t i = 0; i < num_queries; i++) {
+        const t4_stset_key_t * q = queries.keys + i;
+
+        const size_t lower = t4_check_lower_bound(keys, q, t4_check_compare_tree);
+        const bool exact = lower < keys->len && t4_check_compare_tree(keys->keys + lower, q) == 0;
+        const size_t folded_lower = t4_check_lower_bound(keys, q, t4_check_compare_folded);
+        const bool folded = folded_lower < keys->len && t4_check_compare_folded(keys->keys + folded_lower, q) == 0;
+
+        t4_check(check, t4_stree_lower_bound(&tree, q->data, q->size) == lower, "lower_bound is wrong", seed);
+        t4_check(check, t4_stree_exists(&tree, q->data, q->size) == exact, "exists is wrong", seed);
+        t4_check(check, t4_stree_exists_folded(&tree, q->data, q->size) == folded, "exists_folded is wrong", seed);
+
+        size_t index = SIZE_MAX;
+        const bool has_predecessor = t4_stree_predecessor(&tree, q->data, q->size, &index);
+        t4_check(check, has_predecessor == (lower != 0) && (!has_predecessor || index == lower - 1), "predecessor is wrong", seed);
+
+        const size_t after = lower + exact;
+        const bool has_successor = t4_stree_successor(&tree, q->data, q->size, &index);
+        t4_check(check, has_successor == (after < keys->len) && (!has_successor || index == after), "successor is wrong", seed);
+
+        for (size_t j = 0; j + 1 < keys->len && i < 16; j++) {
+            const int order = t4_stree_compare(q->data, q->size, keys->keys[j].data, keys->keys[j].size, false);
+            if (!t4_check(check, order == t4_check_compare_tree(q, keys->keys + j), "compare is wrong", seed)) {
+                break;
+            }
+        }
+    }
+
+    const t4_cpu_features_t features = t4_get_cpu_features();
+    void (*searches[])(const t4_stree_t *, const i64 *, size_t, size_t *) = {
+        t4_internal_stree_search_scalar,
+        features.avx2 ? t4_internal_stree_search_avx2 : t4_internal_stree_search_scalar,
+    };
+
+    u64 result[T4_STSET_BITMAP_WORDS(200)];
+    u64 folded_result[T4_STSET_BITMAP_WORDS(200)];
+
+    for (size_t s = 0; s < sizeof(searches) / sizeof(searches[0]); s++) {
+        tree.search = searches[s];
+
+        for (size_t base = 0; base < num_queries;) {
+            const size_t want = 1 + wyrand(rng) % 200;
+            const size_t n = want < num_queries - base ? want : num_queries - base;
+            const t4_stset_key_t * batch = queries.keys + base;
+
+            t4_stree_exists_batch(&tree, batch, n, result);
+            t4_stree_exists_batch_folded(&tree, batch, n, folded_result);
+
+            for (size_t i = 0; i < n; i++) {
+                const bool exact = t4_stree_exists(&tree, batch[i].data, batch[i].size);
+                const bool folded = t4_stree_exists_folded(&tree, batch[i].data, batch[i].size);
+
+                t4_check(check, t4_stset_bitmap_get(result, i) == exact, "exists_batch differs from exists", seed);
+                t4_check(check, t4_stset_bitmap_get(folded_result, i) == folded, "exists_batch_folded differs from exists_folded", seed);
+            }
+
+            base += n;
+        }
+    }
+
+    t4_check_keys_free(&queries);
+    t4_free(image);
+}
+
+/* n keys for a tree, none equal to another, sorted as by t4_check_compare_tree. */
+static t4_check_keys_t t4_check_tree_keys(u64 * rng, const size_t n) {
+    t4_check_keys_t res = {
+        .buf = t4_calloc(n * 32 + 1, 1),
+        .keys = t4_calloc(n + 1, sizeof(t4_stset_key_t)),
+        .len = n,
+    };
+
+    for (size_t i = 0; i < n; i++) {
+        u8 * data = res.buf + i * 32;
+        res.keys[i] = (t4_stset_key_t) { .data = data, .size = t4_check_tree_key(rng, data), };
+    }
+
+    qsort(res.keys, n, sizeof(t4_stset_key_t), t4_check_compare_tree);
+
+    res.len = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (res.len == 0 || t4_check_compare_tree(res.keys + res.len - 1, res.keys + i) != 0) {
+            res.keys[res.len++] = res.keys[i];
+        }
+    }
+
+    return res;
+}
+
+static bool t4_check_stree(const u64 seed) {
+    t4_check_t check = { .name = "stree", .cases = 0, .failures = 0, };
+
+    /* Around whole nodes and layers of T4_STREE_B keys */
+    static const size_t sizes[] = { 0, 1, 2, 7, 8, 9, 63, 64, 65, 72, 73, 600, 5000, 40000 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t r = 0; r < 4; r++, check.cases++) {
+            u64 rng = seed + s * 4 + r;
+
+            t4_check_keys_t keys = t4_check_tree_keys(&rng, sizes[s]);
+            t4_check_stree_keys(&check, &keys, &rng, seed + s * 4 + r);
+            t4_check_keys_free(&keys);
+        }
+    }
+
+    return t4_check_done(&check);
+}
+
+/* The stset checks use a fixed universe of numbered keys, the extra ones never inserted */
+#define T4_CHECK_SET_KEYS 2000
+#define T4_CHECK_SET_EXTRA 200
+#define T4_CHECK_SET_KEY_MAX 64
+#define T4_CHECK_SET_BATCH 64
+#define T4_CHECK_SET_OPS 24000
+
+/* Operations between switching from mostly inserting to mostly removing and back, and between full comparisons */
+#define T4_CHECK_SET_PHASE 3000
+#define T4_CHECK_SET_VERIFY_EVERY 400
+
+typedef struct {
+    u8 (*data)[T4_CHECK_SET_KEY_MAX];
+    size_t * sizes;
+} t4_check_set_keys_t;
+
+/*
+ * Key i is i in base 26 letters, a '0' and random filler up to a size depending on i % 4, so no two are equal with
+ * ASCII case ignored, some fit in an entry and some do not, and the set they came from can be told from the key.
+ */
+static t4_check_set_keys_t t4_check_set_keys(const u64 seed) {
+    static const size_t max_sizes[] = { 4, T4_STSET_INLINE, 40, T4_CHECK_SET_KEY_MAX };
+    const size_t n = T4_CHECK_SET_KEYS + T4_CHECK_SET_EXTRA;
+
+    t4_check_set_keys_t res = {
+        .data = t4_calloc(n, T4_CHECK_SET_KEY_MAX),
+        .sizes = t4_calloc(n, sizeof(size_t)),
+    };
+
+    u64 rng = seed;
+
+    for (size_t i = 0; i < n; i++) {
+        u8 * buf = res.data[i];
+
+        size_t size = 0;
+        for (size_t x = i;; x /= 26) {
+            buf[size++] = (u8)('a' + x % 26);
+
+            if (x < 26) {
+                break;
+            }
+        }
+        buf[size++] = '0';
+
+        const size_t filler = 1 + wyrand(&rng) % max_sizes[i % 4];
+        if (filler > size) {
+            size += t4_check_key(&rng, buf + size, filler - size);
+        }
+
+        res.sizes[i] = size;
+    }
+
+    return res;
+}
+
+static void t4_check_set_keys_free(t4_check_set_keys_t * self) {
+    t4_free(self->data);
+    t4_free(self->sizes);
+}
+
+/* The number of the key, read back from its letters; past the universe for bytes that are not one of the keys. */
+static size_t t4_check_set_index(const u8 * data, const size_t size) {
+    size_t i = 0;
+    size_t scale = 1;
+
+    for (size_t k = 0; k < size && data[k] != '0'; k++, scale *= 26) {
+        const u8 c = t4_ascii_fold(data[k]);
+
+        if (c < 'a' || c > 'z' || k >= 4) {
+            return SIZE_MAX;
+        }
+
+        i += (size_t)(c - 'a') * scale;
+    }
+
+    return i;
+}
+
+typedef struct {
+    t4_check_t * check;
+    u64 seed;
+    u64 rng;
+    const t4_check_set_keys_t * keys;
+
+    t4_stset_t set;
+    size_t initial_capacity;
+
+    /* Holds every third key, for the fused lookups */
+    t4_stset_t other;
+
+    /* The reference: when every key was inserted, zero if it is not in the set, and the bytes it was inserted with */
+    u64 * inserted_at;
+    u64 inserts;
+    u8 (*kept)[T4_CHECK_SET_KEY_MAX];
+    size_t size;
+    size_t peak;
+
+    /* Keys inserted into a set that does not copy them, which stay here while they are in it */
+    u8 (*fresh)[T4_CHECK_SET_KEY_MAX];
+    u64 * fresh_at;
+    u64 ops;
+
+    /* Every other key given to the set, overwritten after each operation so a set that keeps one is caught */
+    u8 * scratch;
+    size_t scratch_used;
+} t4_check_set_t;
+
+/* Key i as an operation passes it: a case flipped copy with fold_case, the same bytes otherwise. */
+static t4_stset_key_t t4_check_set_arg(t4_check_set_t * s, const size_t i) {
+    const t4_stset_key_t key = { .data = s->keys->data[i], .size = s->keys->sizes[i], };
+    u8 * buf;
+
+    if (!s->set.owns_keys && s->inserted_at[i] == 0) {
+        /* Repeats in a batch must be the same bytes, the first of them may be what the set keeps */
+        buf = s->fresh[i];
+        if (s->fresh_at[i] == s->ops) {
+            return (t4_stset_key_t) { .data = buf, .size = key.size, };
+        }
+        s->fresh_at[i] = s->ops;
+    } else {
+        buf = s->scratch + s->scratch_used;
+        s->scratch_used += T4_CHECK_SET_KEY_MAX;
+    }
+
+    if (s->set.fold_case) {
+        t4_check_flip_case(&s->rng, &key, buf);
+    } else {
+        memcpy(buf, key.data, key.size);
+    }
+
+    return (t4_stset_key_t) { .data = buf, .size = key.size, };
+}
+
+static void t4_check_set_add(t4_check_set_t * s, const size_t i, const t4_stset_key_t * key) {
+    s->inserted_at[i] = ++s->inserts;
+    memcpy(s->kept[i], key->data, key->size);
+
+    s->size++;
+    s->peak = s->size > s->peak ? s->size : s->peak;
+}
+
+static void t4_check_set_drop(t4_check_set_t * s, const size_t i) {
+    s->inserted_at[i] = 0;
+    s->size--;
+}
+
+/* Compares the whole set with the reference: its size, the walk, every key of the universe, and its capacity. */
+static void t4_check_set_verify(t4_check_set_t * s) {
+    t4_check_t * check = s->check;
+    const t4_stset_t * set = &s->set;
+
+    t4_check(check, t4_stset_size(set) == s->size, "size differs", s->seed);
+
+    size_t n = 0;
+    u64 last = 0;
+    bool order = true;
+    bool kept = true;
+
+    const t4_stset_entry_t * e;
+    for (size_t it = 0; (e = t4_stset_next(set, &it)) != NULL; n++) {
+        const u8 * data = t4_stset_entry_data(set, e);
+        const size_t i = t4_check_set_index(data, e->size);
+
+        if (i >= T4_CHECK_SET_KEYS || s->inserted_at[i] == 0) {
+            kept = false;
+            continue;
+        }
+
+        order &= s->inserted_at[i] > last;
+        last = s->inserted_at[i];
+        kept &= e->size == s->keys->sizes[i] && memcmp(data, s->kept[i], e->size) == 0;
+    }
+
+    t4_check(check, n == s->size, "walk has a different number of keys", s->seed);
+    t4_check(check, order, "walk is not in insertion order", s->seed);
+    t4_check(check, kept, "walk has keys other than the ones first inserted", s->seed);
+
+    bool found = true;
+    for (size_t i = 0; i < T4_CHECK_SET_KEYS + T4_CHECK_SET_EXTRA; i++) {
+        const bool in = i < T4_CHECK_SET_KEYS && s->inserted_at[i] != 0;
+        found &= t4_stset_exists(set, s->keys->data[i], s->keys->sizes[i]) == in;
+    }
+    t4_check(check, found, "exists differs", s->seed);
+
+    /* Only growing when a rebuild in place would not free an eighth of the room bounds the slots by the most keys */
+    size_t bound = s->initial_capacity;
+    while ((double)bound * set->max_load_factor * 7 / 8 < (double)s->peak + 16) {
+        bound *= 2;
+    }
+    t4_check(check, set->capacity <= bound, "grew instead of rebuilding in place", s->seed);
+}
+
+/* One of the batch operations on up to T4_CHECK_SET_BATCH keys near key i, repeats included. */
+static void t4_check_set_batch(t4_check_set_t * s, const size_t i, const u64 kind) {
+    t4_check_t * check = s->check;
+
+    const size_t n = 1 + wyrand(&s->rng) % T4_CHECK_SET_BATCH;
+    size_t idx[T4_CHECK_SET_BATCH];
+    t4_stset_key_t keys[T4_CHECK_SET_BATCH];
+
+    for (size_t k = 0; k < n; k++) {
+        idx[k] = (i + wyrand(&s->rng) % n) % T4_CHECK_SET_KEYS;
+        keys[k] = t4_check_set_arg(s, idx[k]);
+    }
+
+    /* Set to ones first, every bit has to be written */
+    u64 result[T4_STSET_BITMAP_WORDS(T4_CHECK_SET_BATCH)];
+    u64 in_other[T4_STSET_BITMAP_WORDS(T4_CHECK_SET_BATCH)];
+    memset(result, 0xff, sizeof(result));
+    memset(in_other, 0xff, sizeof(in_other));
+
+    if (kind == 0) {
+        t4_stset_try_insert_batch(&s->set, keys, n, result);
+    } else if (kind == 1) {
+        t4_stset_exists_batch(&s->set, keys, n, result);
+    } else {
+        t4_stset_try_insert_exists_batch(&s->set, &s->other, keys, n, result, in_other);
+    }
+
+    bool ok = true;
+    for (size_t k = 0; k < n; k++) {
+        const bool had = s->inserted_at[idx[k]] != 0;
+
+        if (kind == 1) {
+            ok &= t4_stset_bitmap_get(result, k) == had;
+            continue;
+        }
+
+        ok &= t4_stset_bitmap_get(result, k) == !had;
+        if (kind == 2) {
+            ok &= t4_stset_bitmap_get(in_other, k) == (!had && idx[k] % 3 == 0);
+        }
+
+        if (!had) {
+            t4_check_set_add(s, idx[k], keys + k);
+        }
+    }
+
+    static const char * what[] = { "try_insert_batch differs", "exists_batch differs", "try_insert_exists_batch differs" };
+    t4_check(check, ok, what[kind], s->seed);
+}
+
+/* One random operation on the set and the reference alike, mostly inserting or, when draining, mostly removing. */
+static void t4_check_set_op(t4_check_set_t * s, const bool draining) {
+    t4_check_t * check = s->check;
+    t4_stset_t * set = &s->set;
+
+    s->ops++;
+
+    const size_t i = wyrand(&s->rng) % T4_CHECK_SET_KEYS;
+    const bool had = s->inserted_at[i] != 0;
+    const u64 op = wyrand(&s->rng) % (draining ? 14 : 9);
+    const t4_stset_key_t key = t4_check_set_arg(s, i);
+
+    switch (op) {
+    case 0:
+        t4_check(check, t4_stset_try_insert(set, key.data, key.size) == !had, "try_insert differs", s->seed);
+        if (!had) {
+            t4_check_set_add(s, i, &key);
+        }
+        break;
+    case 1:
+        if (!had) {
+            t4_stset_insert_unchecked(set, key.data, key.size);
+            t4_check_set_add(s, i, &key);
+        }
+        t4_check(check, t4_stset_exists(set, key.data, key.size), "insert_unchecked did not insert", s->seed);
+        break;
+    case 2: {
+        /* Without fold_case a copy with its case flipped is only the key if it is the same bytes */
+        u8 flipped[T4_CHECK_SET_KEY_MAX];
+        t4_check_flip_case(&s->rng, &key, flipped);
+
+        const bool in = had && (set->fold_case || memcmp(flipped, s->kept[i], key.size) == 0);
+        t4_check(check, t4_stset_exists(set, flipped, key.size) == in, "exists differs", s->seed);
+        break;
+    }
+    case 3: {
+        const u64 hash = t4_stset_hash_for(set, key.data, key.size);
+        const u64 which = wyrand(&s->rng) % 3;
+
+        if (which == 0) {
+            t4_check(check, t4_stset_try_insert_with_hash(set, hash, key.data, key.size) == !had, "try_insert_with_hash differs", s->seed);
+            if (!had) {
+                t4_check_set_add(s, i, &key);
+            }
+        } else if (which == 1) {
+            t4_check(check, t4_stset_exists_with_hash(set, hash, key.data, key.size) == had, "exists_with_hash differs", s->seed);
+        } else {
+            t4_check(check, t4_stset_remove_with_hash(set, hash, key.data, key.size) == had, "remove_with_hash differs", s->seed);
+            if (had) {
+                t4_check_set_drop(s, i);
+            }
+        }
+        break;
+    }
+    case 4: {
+        const u32 want = had ? 0 : T4_STSET_INSERTED | (i % 3 == 0 ? T4_STSET_IN_OTHER : 0);
+        t4_check(check, t4_stset_try_insert_exists(set, &s->other, key.data, key.size) == want, "try_insert_exists differs", s->seed);
+        if (!had) {
+            t4_check_set_add(s, i, &key);
+        }
+        break;
+    }
+    case 5:
+    case 6:
+    case 7:
+        t4_check_set_batch(s, i, op - 5);
+        break;
+    default: {
+        /* A run of keys from i on, just the one unless draining */
+        const size_t n = op == 8 ? 1 : 1 + wyrand(&s->rng) % T4_CHECK_SET_BATCH;
+
+        for (size_t k = 0; k < n; k++) {
+            const size_t j = (i + k) % T4_CHECK_SET_KEYS;
+            const bool in = s->inserted_at[j] != 0;
+            const t4_stset_key_t other = k == 0 ? key : t4_check_set_arg(s, j);
+
+            t4_check(check, t4_stset_remove(set, other.data, other.size) == in, "remove differs", s->seed);
+            if (in) {
+                t4_check_set_drop(s, j);
+            }
+        }
+        break;
+    }
+    }
+
+    memset(s->scratch, 0xa5, s->scratch_used);
+    s->scratch_used = 0;
+}
+
+static void t4_check_set_case(t4_check_t * check, const t4_check_set_keys_t * keys, const u64 seed, const bool fold_case, const bool owning, const float max_load_factor) {
+    t4_check_set_t s = {
+        .check = check,
+        .seed = seed,
+        .rng = seed,
+        .keys = keys,
+        .set = owning ? t4_stset_new_owning(0) : t4_stset_new(0),
+        .other = t4_stset_new(0),
+        .inserted_at = t4_calloc(T4_CHECK_SET_KEYS, sizeof(u64)),
+        .kept = t4_calloc(T4_CHECK_SET_KEYS, T4_CHECK_SET_KEY_MAX),
+        .fresh = t4_calloc(T4_CHECK_SET_KEYS, T4_CHECK_SET_KEY_MAX),
+        .fresh_at = t4_calloc(T4_CHECK_SET_KEYS, sizeof(u64)),
+        .scratch = t4_calloc(T4_CHECK_SET_BATCH + 2, T4_CHECK_SET_KEY_MAX),
+    };
+
+    t4_stset_set_fold_case(&s.set, fold_case);
+    t4_stset_set_max_load_factor(&s.set, max_load_factor);
+    s.initial_capacity = s.set.capacity;
+
+    t4_stset_set_fold_case(&s.other, fold_case);
+    for (size_t i = 0; i < T4_CHECK_SET_KEYS; i += 3) {
+        t4_stset_insert_unchecked(&s.other, keys->data[i], keys->sizes[i]);
+    }
+
+    for (size_t op = 0; op < T4_CHECK_SET_OPS; op++) {
+        t4_check_set_op(&s, op / T4_CHECK_SET_PHASE % 2 == 1);
+
+        if ((op + 1) % T4_CHECK_SET_VERIFY_EVERY == 0) {
+            t4_check_set_verify(&s);
+        }
+    }
+
+    t4_stset_free(&s.set);
+    t4_stset_free(&s.other);
+    t4_free(s.inserted_at);
+    t4_free(s.kept);
+    t4_free(s.fresh);
+    t4_free(s.fresh_at);
+    t4_free(s.scratch);
+}
+
+/* Counts of the keys in a map, upserting, getting and removing them at random; values must start out zeroed. */
+static void t4_check_map_case(t4_check_t * check, const t4_check_set_keys_t * keys, const u64 seed, const bool owning) {
+    t4_stmap_t map = owning ? t4_stmap_new_owning(0, sizeof(u64)) : t4_stmap_new(0, sizeof(u64));
+    u64 * counts = t4_calloc(T4_CHECK_SET_KEYS, sizeof(u64));
+    size_t size = 0;
+    u8 scratch[T4_CHECK_SET_KEY_MAX];
+
+    u64 rng = seed;
+
+    for (size_t op = 0; op < T4_CHECK_SET_OPS; op++) {
+        const size_t i = wyrand(&rng) % T4_CHECK_SET_KEYS;
+        const bool draining = op / T4_CHECK_SET_PHASE % 2 == 1;
+
+        /* An owning map gets a copy that is overwritten right after */
+        u8 * data = keys->data[i];
+        if (owning) {
+            memcpy(scratch, data, keys->sizes[i]);
+            data = scratch;
+        }
+
+        const u64 which = wyrand(&rng) % (draining ? 6 : 4);
+        if (which < 2) {
+            bool inserted;
+            u64 * value = t4_stmap_upsert(&map, data, keys->sizes[i], &inserted);
+
+            t4_check(check, inserted == (counts[i] == 0) && *value == counts[i], "upsert differs", seed);
+            size += counts[i] == 0;
+            counts[i] = ++*value;
+        } else if (which == 2) {
+            const u64 * value = t4_stmap_get(&map, data, keys->sizes[i]);
+
+            t4_check(check, value == NULL ? counts[i] == 0 : *value == counts[i], "get differs", seed);
+        } else {
+            t4_check(check, t4_stmap_remove(&map, data, keys->sizes[i]) == (counts[i] != 0), "remove differs", seed);
+            size -= counts[i] != 0;
+            counts[i] = 0;
+        }
+
+        memset(scratch, 0xa5, sizeof(scratch));
+
+        if ((op + 1) % T4_CHECK_SET_VERIFY_EVERY == 0) {
+            size_t n = 0;
+            bool values = true;
+
+            const t4_stset_entry_t * e;
+            void * value;
+            for (size_t it = 0; (e = t4_stmap_next(&map, &it, &value)) != NULL; n++) {
+                const size_t j = t4_check_set_index(t4_stset_entry_data(&map.set, e), e->size);
+                values &= j < T4_CHECK_SET_KEYS && counts[j] != 0 && *(u64 *)value == counts[j];
+            }
+
+            t4_check(check, n == size && t4_stmap_size(&map) == size, "map size differs", seed);
+            t4_check(check, values, "walk of the map has other values", seed);
+        }
+    }
+
+    t4_stmap_free(&map);
+    t4_free(counts);
+}
+
+#define T4_CHECK_SHARDED_THREADS 4
+
+typedef struct {
+    t4_stset_sharded_t * set;
+    const t4_check_set_keys_t * keys;
+    u64 seed;
+    bool owning;
+    u32 * wins;
+} t4_check_sharded_job_t;
+
+/* Inserts every key in an order of its own, counting the inserts that reported the key new. */
+static void * t4_check_sharded_thread(void * arg) {
+    const t4_check_sharded_job_t * job = arg;
+    u8 scratch[T4_CHECK_SET_KEY_MAX];
+
+    u64 rng = job->seed;
+    const size_t start = wyrand(&rng) % T4_CHECK_SET_KEYS;
+
+    /* Odd and not a multiple of 5, so it steps through every one of the 2000 keys */
+    const size_t stride = 10 * (wyrand(&rng) % 200) + 1 + 2 * (wyrand(&rng) % 2);
+
+    for (size_t k = 0; k < T4_CHECK_SET_KEYS; k++) {
+        const size_t i = (start + k * stride) % T4_CHECK_SET_KEYS;
+
+        u8 * data = job->keys->data[i];
+        if (job->owning) {
+            memcpy(scratch, data, job->keys->sizes[i]);
+            data = scratch;
+        }
+
+        if (t4_stset_sharded_try_insert(job->set, data, job->keys->sizes[i])) {
+            __atomic_fetch_add(&job->wins[i], 1, __ATOMIC_RELAXED);
+        }
+
+        memset(scratch, 0xa5, sizeof(scratch));
+    }
+
+    return NULL;
+}
+
+/* Threads inserting the same keys into a sharded set at once: each must be reported new exactly once. */
+static void t4_check_sharded_case(t4_check_t * check, const t4_check_set_keys_t * keys, const u64 seed, const bool owning) {
+    t4_stset_sharded_t set = owning ? t4_stset_sharded_new_owning(0, 8) : t4_stset_sharded_new(0, 8);
+    u32 * wins = t4_calloc(T4_CHECK_SET_KEYS, sizeof(u32));
+
+    pthread_t threads[T4_CHECK_SHARDED_THREADS];
+    t4_check_sharded_job_t jobs[T4_CHECK_SHARDED_THREADS];
+
+    for (size_t t = 0; t < T4_CHECK_SHARDED_THREADS; t++) {
+        jobs[t] = (t4_check_sharded_job_t) { .set = &set, .keys = keys, .seed = seed + t, .owning = owning, .wins = wins, };
+
+        if (pthread_create(&threads[t], NULL, t4_check_sharded_thread, &jobs[t]) != 0) {
+            fprintf(stderr, "t4_check: could not start a thread\n");
+            exit(1);
+        }
+    }
+
+    for (size_t t = 0; t < T4_CHECK_SHARDED_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    bool once = true;
+    bool found = true;
+    for (size_t i = 0; i < T4_CHECK_SET_KEYS; i++) {
+        once &= wins[i] == 1;
+        found &= t4_stset_sharded_exists(&set, keys->data[i], keys->sizes[i]);
+    }
+
+    t4_check(check, once, "sharded insert not new exactly once", seed);
+    t4_check(check, found && t4_stset_sharded_size(&set) == T4_CHECK_SET_KEYS, "sharded set lost keys", seed);
+
+    /* The extra keys go through the fused insert, every third of them being in other */
+    t4_stset_t other = t4_stset_new(0);
+    for (size_t i = T4_CHECK_SET_KEYS; i < T4_CHECK_SET_KEYS + T4_CHECK_SET_EXTRA; i += 3) {
+        t4_stset_insert_unchecked(&other, keys->data[i], keys->sizes[i]);
+    }
+
+    bool fused = true;
+    for (size_t i = T4_CHECK_SET_KEYS; i < T4_CHECK_SET_KEYS + T4_CHECK_SET_EXTRA; i++) {
+        fused &= !t4_stset_sharded_exists(&set, keys->data[i], keys->sizes[i]);
+
+        const u32 want = T4_STSET_INSERTED | ((i - T4_CHECK_SET_KEYS) % 3 == 0 ? T4_STSET_IN_OTHER : 0);
+        fused &= t4_stset_sharded_try_insert_exists(&set, &other, keys->data[i], keys->sizes[i]) == want;
+        fused &= t4_stset_sharded_try_insert_exists(&set, &other, keys->data[i], keys->sizes[i]) == 0;
+    }
+    t4_check(check, fused, "sharded try_insert_exists differs", seed);
+
+    t4_stset_free(&other);
+    t4_stset_sharded_free(&set);
+    t4_free(wins);
+}
+
+/* Every kind of set and map on whichever backend is in use. */
+static bool t4_check_stset_backend(const char * isa, const t4_check_set_keys_t * keys, const u64 seed) {
+    char name[32];
+    snprintf(name, sizeof(name), "stset %s", isa);
+
+    t4_check_t check = { .name = name, .cases = 0, .failures = 0, };
+
+    static const float load_factors[] = { 0.5f, T4_STSET_DEFAULT_MAX_LOAD_FACTOR, 1.0f };
+
+    for (size_t l = 0; l < sizeof(load_factors) / sizeof(load_factors[0]); l++) {
+        for (size_t c = 0; c < 4; c++, check.cases++) {
+            t4_check_set_case(&check, keys, seed + check.cases, c & 1, c & 2, load_factors[l]);
+        }
+    }
+
+    for (size_t owning = 0; owning < 2; owning++, check.cases++) {
+        t4_check_map_case(&check, keys, seed + check.cases, owning);
+    }
+
+    for (size_t owning = 0; owning < 2; owning++, check.cases++) {
+        t4_check_sharded_case(&check, keys, seed + check.cases, owning);
+    }
+
+    return t4_check_done(&check);
+}
+
+static bool t4_check_stset(const u64 seed) {
+    t4_check_set_keys_t keys = t4_check_set_keys(seed);
+    bool ok = true;
+
+#if defined(T4_CHECK_DISPATCH)
+    ok &= t4_check_stset_backend(T4_CHECK_DISPATCH, &keys, seed);
+#else
+    for (enum t4_stset_isa isa = 0; isa < T4_STSET_ISA_COUNT; isa++) {
+        if (t4_internal_stset_init_isa(isa)) {
+            ok &= t4_check_stset_backend(t4_internal_stset_isa_name(isa), &keys, seed);
+        }
+    }
+
+    t4_internal_stset_init();
+#endif
+
+    t4_check_set_keys_free(&keys);
+    return ok;
+}
+
+int main(const int argc, const char * argv[]) {
+    if (argc != 1) {
+        fprintf(stderr, "Usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    const char * seed_env = getenv("T4_CHECK_SEED");
+    const u64 seed = seed_env != NULL ? strtoull(seed_env, NULL, 10) : 0;
+
+    bool ok = true;
+    ok &= t4_check_tokenize(seed);
+    ok &= t4_check_phf(seed);
+    ok &= t4_check_stree(seed);
+    ok &= t4_check_stset(seed);
+
+    return ok ? 0 : 1;
+}
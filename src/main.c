@@ -1,24 +1,201 @@
 #include "t4/common.h"
 #include "t4/stset.h"
+#include "t4/stmap.h"
+#include "t4/stset_snapshot.h"
+#include "t4/phf.h"
+#include "t4/stree.h"
+#include "t4/bloom.h"
+#include "t4/topk.h"
+#include "t4/tokenize.h"
+#include "t4/stream.h"
 #include "t4/mem.h"
+#include "t4/internal/ascii_fold.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <string.h>
-#include <ctype.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 typedef struct {
     char * buf;
     size_t size;
+    /* Set by t4_map_file, buf is then read-only */
+    bool mapped;
 } t4_filebuf_t;
 
+/* Words are looked up in batches of this many, so the cache misses into the sets can overlap. */
+#define T4_WORD_BATCH 64
+
+typedef struct {
+    u64 non_english;
+    u64 num_unique;
+    u64 num_total;
+    /* How the filter in front of the dictionary did (-b) */
+    t4_bloom_stats_t filter;
+} t4_counts_t;
+
+/* sorted.bin as a perfect hash (-d phf), made by t4_mkphf while building and linked in as is, see CMakeLists.txt */
+__asm__(
+    "    .section .rodata\n"
+    "    .balign 64\n"
+    "t4_dict_phf_image:\n"
+    "    .incbin \"" T4_DICT_PHF "\"\n"
+    "t4_dict_phf_image_end:\n"
+    "    .previous\n");
+
+extern const u8 t4_dict_phf_image[];
+extern const u8 t4_dict_phf_image_end[];
+
+/* Same for the search tree (-d tree), made by t4_mkstree */
+__asm__(
+    "    .section .rodata\n"
+    "    .balign 64\n"
+    "t4_dict_stree_image:\n"
+    "    .incbin \"" T4_DICT_STREE "\"\n"
+    "t4_dict_stree_image_end:\n"
+    "    .previous\n");
+
+extern const u8 t4_dict_stree_image[];
+extern const u8 t4_dict_stree_image_end[];
+
+/* -d */
+typedef enum {
+    T4_DICT_KIND_PHF,
+    T4_DICT_KIND_STREE,
+    T4_DICT_KIND_STSET,
+} t4_dict_kind_t;
+
+/* The english dictionary, looked up once for every distinct word */
+typedef struct {
+    t4_dict_kind_t kind;
+    /* -d stset, NULL otherwise */
+    const t4_stset_t * set;
+    t4_phf_t phf;
+    t4_stree_t tree;
+    /* Words of a mapped input keep their case, which the perfect hash and tree then have to ignore like the sets do */
+    bool fold_case;
+    /* -b, NULL without; checked before any of the above */
+    const t4_bloom_t * bloom;
+} t4_dict_t;
+
+static bool t4_dict_lookup(const t4_dict_t * dict, const void * data, const size_t size) {
+    if (dict->kind == T4_DICT_KIND_STSET) {
+        return t4_stset_exists(dict->set, data, size);
+    }
+
+    if (dict->kind == T4_DICT_KIND_STREE) {
+        return dict->fold_case ? t4_stree_exists_folded(&dict->tree, data, size) : t4_stree_exists(&dict->tree, data, size);
+    }
+
+    return dict->fold_case ? t4_phf_exists_folded(&dict->phf, data, size) : t4_phf_exists(&dict->phf, data, size);
+}
+
+static bool t4_dict_exists(const t4_dict_t * dict, const void * data, const size_t size, t4_bloom_stats_t * filter) {
+    if (dict->bloom == NULL) {
+        return t4_dict_lookup(dict, data, size);
+    }
+
+    filter->lookups += 1;
+    if (!t4_bloom_may_contain(dict->bloom, data, size)) {
+        filter->rejected += 1;
+        return false;
+    }
+
+    const bool res = t4_dict_lookup(dict, data, size);
+    filter->false_positives += !res;
+    return res;
+}
+
+/*
+ * Sets bit i of result for every word i of at most T4_WORD_BATCH marked in is_new which is in dict. The words the
+ * filter lets through are then looked up all at once, where the dictionary can do that.
+ */
+static void t4_dict_exists_batch(const t4_dict_t * dict, const t4_stset_key_t * words, const size_t n, const u64 * is_new,
+                                 u64 * result, t4_bloom_stats_t * filter) {
+    t4_stset_key_t fresh[T4_WORD_BATCH];
+    size_t fresh_index[T4_WORD_BATCH];
+    size_t num_fresh = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!t4_stset_bitmap_get(is_new, i)) {
+            continue;
+        }
+
+        if (dict->bloom != NULL) {
+            filter->lookups += 1;
+
+            if (!t4_bloom_may_contain(dict->bloom, words[i].data, words[i].size)) {
+                filter->rejected += 1;
+                continue;
+            }
+        }
+
+        fresh_index[num_fresh] = i;
+        fresh[num_fresh++] = words[i];
+    }
+
+    u64 found[T4_STSET_BITMAP_WORDS(T4_WORD_BATCH)] = { 0 };
+
+    if (dict->kind == T4_DICT_KIND_STSET) {
+        t4_stset_exists_batch(dict->set, fresh, num_fresh, found);
+    } else if (dict->kind == T4_DICT_KIND_STREE && dict->fold_case) {
+        t4_stree_exists_batch_folded(&dict->tree, fresh, num_fresh, found);
+    } else if (dict->kind == T4_DICT_KIND_STREE) {
+        t4_stree_exists_batch(&dict->tree, fresh, num_fresh, found);
+    } else {
+        for (size_t j = 0; j < num_fresh; j++) {
+            found[j / 64] |= (u64)t4_dict_lookup(dict, fresh[j].data, fresh[j].size) << (j % 64);
+        }
+    }
+
+    memset(result, 0, T4_STSET_BITMAP_WORDS(n) * sizeof(u64));
+    for (size_t j = 0; j < num_fresh; j++) {
+        const bool english = t4_stset_bitmap_get(found, j);
+
+        result[fresh_index[j] / 64] |= (u64)english << (fresh_index[j] % 64);
+        filter->false_positives += dict->bloom != NULL && !english;
+    }
+}
+
+/* Puts every word of dict into bloom. */
+static void t4_dict_fill_bloom(const t4_dict_t * dict, t4_bloom_t * bloom) {
+    if (dict->kind == T4_DICT_KIND_STSET) {
+        const t4_stset_entry_t * e;
+        for (size_t it = 0; (e = t4_stset_next(dict->set, &it)) != NULL;) {
+            t4_bloom_insert(bloom, t4_stset_entry_data(dict->set, e), e->size);
+        }
+    } else if (dict->kind == T4_DICT_KIND_STREE) {
+        for (size_t i = 0; i < t4_stree_size(&dict->tree); i++) {
+            size_t size;
+            const u8 * key = t4_stree_key(&dict->tree, i, &size);
+            t4_bloom_insert(bloom, key, size);
+        }
+    } else {
+        for (size_t i = 0; i < dict->phf.num_keys; i++) {
+            const u32 begin = dict->phf.offsets[i];
+            t4_bloom_insert(bloom, dict->phf.keys + begin, dict->phf.offsets[i + 1] - begin);
+        }
+    }
+}
+
+/* Value of every word in the counting mode (-k) */
+typedef struct {
+    u64 count;
+    bool english;
+} t4_word_stats_t;
+
 static t4_filebuf_t t4_read_file(const char * fp, const size_t alignment) {
     FILE * f = fopen(fp, "rb");
     if (f == NULL) {
-        return (t4_filebuf_t) { .buf = NULL, .size = 0, };
+        return (t4_filebuf_t) { .buf = NULL, .size = 0, .mapped = false, };
     }
 
-    t4_filebuf_t res;
+    t4_filebuf_t res = { .mapped = false, };
 
     fseek(f, 0l, SEEK_END);
     res.size = ftell(f);
@@ -38,82 +215,609 @@ static t4_filebuf_t t4_read_file(const char * fp, const size_t alignment) {
     return res;
 }
 
-int main(const int argc, const char * argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s [filename]\n", argv[0]);
+/**
+ * Maps a regular file read-only (-m), all of it read in up front (MAP_POPULATE) and readahead hinted as sequential.
+ * As nothing is copied nor written, words keep their case and the sets fold it instead, see t4_make_words. This
+ * keeps the input out of the heap and saves the copy, but folding on every lookup costs a few ns per word, more
+ * than lowercasing a copy in place does, so it is not the default.
+ */
+static t4_filebuf_t t4_map_file(const char * fp) {
+    /* An empty file cannot be mapped, nor does it need to be. */
+    static char empty[1];
+
+    t4_filebuf_t res = { .buf = NULL, .size = 0, .mapped = true, };
+
+    const int fd = open(fp, O_RDONLY);
+    if (fd < 0) {
+        return res;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        res.size = (size_t)st.st_size;
+        res.buf = empty;
+
+        if (res.size != 0) {
+            void * map = mmap(NULL, res.size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            res.buf = map != MAP_FAILED ? map : NULL;
+        }
+
+        if (res.buf != NULL && res.size != 0) {
+            madvise(res.buf, res.size, MADV_SEQUENTIAL);
+        }
+    }
+
+    close(fd);
+
+    return res;
+}
+
+static void t4_unmap_file(t4_filebuf_t * f) {
+    if (f->size != 0) {
+        munmap(f->buf, f->size);
+    }
+
+    f->buf = NULL;
+    f->size = 0;
+}
+
+/* Room for the folded copies of one batch of words, reused from one batch to the next. */
+typedef struct {
+    char * buf;
+    size_t capacity;
+} t4_scratch_t;
+
+/**
+ * Points words at the tokens of buf. The words of a mapped file stay where they are, the sets fold their ASCII case
+ * on the fly, except for the ones with other characters: those are folded in a copy in scratch, valid until the
+ * next call. They can only be among the tokens if check is set, see t4_tokenizer_t.non_ascii.
+ */
+static void t4_make_words(char * buf, const bool check, const t4_token_t * tokens, const size_t n,
+                          t4_stset_key_t * words, t4_scratch_t * scratch) {
+    t4_debug_assert(n <= 64);
+
+    u64 fold = 0;
+    size_t needed = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        words[i] = (t4_stset_key_t) { .data = buf + tokens[i].offset, .size = tokens[i].size, };
+
+        if (check && !t4_ascii_only(words[i].data, words[i].size)) {
+            fold |= 1llu << i;
+            needed += words[i].size;
+        }
+    }
+
+    if (fold == 0) {
+        return;
+    }
+
+    if (needed > scratch->capacity) {
+        scratch->capacity = needed * 2;
+        scratch->buf = t4_realloc(scratch->buf, scratch->capacity, 1);
+    }
+
+    char * copy = scratch->buf;
+    for (; fold != 0; fold &= fold - 1) {
+        t4_stset_key_t * word = words + __builtin_ctzll(fold);
+
+        memcpy(copy, word->data, word->size);
+        t4_tokenize_fold(copy, word->size);
+
+        word->data = copy;
+        copy += word->size;
+    }
+}
+
+/* Words keep the case they first appeared in when the input is mapped, so ASCII is lowercased on the way out. */
+static void t4_print_word(const char * word, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        putchar(t4_ascii_fold((u8)word[i]));
+    }
+
+    putchar('\n');
+}
+
+/* Inserts words into in and prints the new ones which are not in dict, in their original order. */
+static void t4_process_words(t4_stset_t * in, const t4_dict_t * dict, const t4_stset_key_t * words, const size_t n, t4_counts_t * counts) {
+    u64 is_new[T4_STSET_BITMAP_WORDS(T4_WORD_BATCH)];
+    u64 is_english[T4_STSET_BITMAP_WORDS(T4_WORD_BATCH)];
+
+    /* A set dictionary is probed along with in, both with the same hash, unless a filter goes first. */
+    if (dict->kind == T4_DICT_KIND_STSET && dict->bloom == NULL) {
+        t4_stset_try_insert_exists_batch(in, dict->set, words, n, is_new, is_english);
+    } else {
+        t4_stset_try_insert_batch(in, words, n, is_new);
+        t4_dict_exists_batch(dict, words, n, is_new, is_english, &counts->filter);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (!t4_stset_bitmap_get(is_new, i)) {
+            continue;
+        }
+
+        counts->num_unique += 1;
+
+        if (!t4_stset_bitmap_get(is_english, i)) {
+            counts->non_english += 1;
+            t4_print_word(words[i].data, words[i].size);
+        }
+    }
+
+    counts->num_total += n;
+}
+
+/* Same as t4_process_words, but also counts every occurrence; dict is only probed the first time a word is seen. */
+static void t4_count_words(t4_stmap_t * in, const t4_dict_t * dict, const t4_stset_key_t * words, const size_t n, t4_counts_t * counts) {
+    for (size_t i = 0; i < n; i++) {
+        bool is_new;
+        t4_word_stats_t * stats = t4_stmap_upsert(in, words[i].data, words[i].size, &is_new);
+
+        if (is_new) {
+            counts->num_unique += 1;
+
+            stats->english = t4_dict_exists(dict, words[i].data, words[i].size, &counts->filter);
+            if (!stats->english) {
+                counts->non_english += 1;
+                t4_print_word(words[i].data, words[i].size);
+            }
+        }
+
+        stats->count += 1;
+    }
+
+    counts->num_total += n;
+}
+
+/**
+ * Tokenizes the whole input on this thread, lowercasing it in place unless it is mapped.
+ *
+ * @param in_counts Filled with every word if not NULL (-k), otherwise in is
+ */
+static void t4_scan(const t4_filebuf_t * f, const t4_dict_t * dict, t4_stset_t * in, t4_stmap_t * in_counts, t4_counts_t * counts) {
+    t4_tokenizer_t tokenizer = f->mapped ? t4_tokenizer_new_readonly(f->buf, f->size) : t4_tokenizer_new(f->buf, f->size);
+    t4_token_t tokens[T4_WORD_BATCH];
+    t4_stset_key_t words[T4_WORD_BATCH];
+    t4_scratch_t scratch = { .buf = NULL, .capacity = 0, };
+
+    /* non_ascii before the previous batch and before this one */
+    size_t seen = 0;
+    size_t last = 0;
+
+    size_t num_words;
+    while ((num_words = t4_tokenize(&tokenizer, tokens, T4_WORD_BATCH)) != 0) {
+        t4_make_words(f->buf, f->mapped && tokenizer.non_ascii != seen, tokens, num_words, words, &scratch);
+        seen = last;
+        last = tokenizer.non_ascii;
+
+        if (in_counts != NULL) {
+            t4_count_words(in_counts, dict, words, num_words, counts);
+        } else {
+            t4_process_words(in, dict, words, num_words, counts);
+        }
+    }
+
+    t4_free(scratch.buf);
+}
+
+/* One range of the input in the parallel mode (-j), tokenized by its own thread. */
+typedef struct {
+    char * begin;
+    char * end;
+    /* Whether the range is part of a mapped file, see t4_make_words */
+    bool mapped;
+    const t4_dict_t * dict;
+    /* Every distinct word of the range in order of first occurrence, with t4_word_stats_t for the range only */
+    t4_stmap_t words;
+    u64 num_total;
+    t4_bloom_stats_t filter;
+} t4_scan_job_t;
+
+/* Smallest range worth a thread of its own, so a small input or the last chunk of a stream is not split thinly */
+#define T4_SCAN_MIN_RANGE (64 * 1024)
+
+static void * t4_scan_range(void * arg) {
+    t4_scan_job_t * job = arg;
+    /* Folded copies only last for a batch, so words of a mapped file have to be owned. */
+    job->words = job->mapped ? t4_stmap_new_owning(10000, sizeof(t4_word_stats_t)) : t4_stmap_new(10000, sizeof(t4_word_stats_t));
+    t4_stset_set_fold_case(&job->words.set, job->mapped);
+
+    const size_t size = job->end - job->begin;
+    t4_tokenizer_t tokenizer = job->mapped ? t4_tokenizer_new_readonly(job->begin, size) : t4_tokenizer_new(job->begin, size);
+    t4_token_t tokens[T4_WORD_BATCH];
+    t4_stset_key_t words[T4_WORD_BATCH];
+    t4_scratch_t scratch = { .buf = NULL, .capacity = 0, };
+
+    /* non_ascii before the previous batch and before this one */
+    size_t seen = 0;
+    size_t last = 0;
+
+    size_t num_words;
+    while ((num_words = t4_tokenize(&tokenizer, tokens, T4_WORD_BATCH)) != 0) {
+        t4_make_words(job->begin, job->mapped && tokenizer.non_ascii != seen, tokens, num_words, words, &scratch);
+        seen = last;
+        last = tokenizer.non_ascii;
+
+        for (size_t i = 0; i < num_words; i++) {
+            bool is_new;
+            t4_word_stats_t * stats = t4_stmap_upsert(&job->words, words[i].data, words[i].size, &is_new);
+            if (is_new) {
+                stats->english = t4_dict_exists(job->dict, words[i].data, words[i].size, &job->filter);
+            }
+
+            stats->count += 1;
+        }
+
+        job->num_total += num_words;
+    }
+
+    t4_free(scratch.buf);
+
+    return NULL;
+}
+
+/**
+ * Splits the input between up to num_threads threads, but no more than one per T4_SCAN_MIN_RANGE bytes, each
+ * collecting the words of its own range, then merges the ranges in input order. Walking each range's words in order
+ * of first occurrence within it visits every word for the first time at its first occurrence in the whole input, so
+ * the output is the same as the sequential one.
+ *
+ * @param in_counts Filled with every word if not NULL (-k), otherwise in is
+ */
+static void t4_scan_parallel(const t4_filebuf_t * f, const t4_dict_t * dict, const size_t num_threads,
+                             t4_stset_t * in, t4_stmap_t * in_counts, t4_counts_t * counts) {
+    const size_t max_ranges = f->size / T4_SCAN_MIN_RANGE != 0 ? f->size / T4_SCAN_MIN_RANGE : 1;
+    const size_t num_ranges = num_threads < max_ranges ? num_threads : max_ranges;
+
+    t4_scan_job_t * jobs = t4_calloc(num_ranges, sizeof(t4_scan_job_t));
+    pthread_t * threads = t4_calloc(num_ranges, sizeof(pthread_t));
+    bool * started = t4_calloc(num_ranges, sizeof(bool));
+
+    size_t begin = 0;
+    for (size_t t = 0; t < num_ranges; t++) {
+        size_t end = f->size;
+
+        if (t + 1 < num_ranges) {
+            const size_t split = f->size / num_ranges * (t + 1);
+            end = t4_tokenize_split_point(f->buf, f->size, split > begin ? split : begin);
+        }
+
+        jobs[t] = (t4_scan_job_t) { .begin = f->buf + begin, .end = f->buf + end, .mapped = f->mapped, .dict = dict, .num_total = 0, .filter = { 0 }, };
+        /* A range that gets no thread is scanned right here instead, it is still merged in order below. */
+        started[t] = pthread_create(&threads[t], NULL, t4_scan_range, &jobs[t]) == 0;
+        if (!started[t]) {
+            t4_scan_range(&jobs[t]);
+        }
+
+        begin = end;
+    }
+
+    for (size_t t = 0; t < num_ranges; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+
+        void * value;
+        const t4_stset_entry_t * e;
+        for (size_t it = 0; (e = t4_stmap_next(&jobs[t].words, &it, &value)) != NULL;) {
+            const t4_word_stats_t * stats = value;
+            /* Inline keys are copied, the rest points into the input or, for a mapped one, the job's own copy. */
+            void * data = (void *)t4_stset_entry_data(&jobs[t].words.set, e);
+
+            bool is_new;
+            if (in_counts != NULL) {
+                t4_word_stats_t * total = t4_stmap_upsert(in_counts, data, e->size, &is_new);
+                total->english = stats->english;
+                total->count += stats->count;
+            } else {
+                is_new = t4_stset_try_insert(in, data, e->size);
+            }
+
+            if (is_new) {
+                counts->num_unique += 1;
+
+                if (!stats->english) {
+                    counts->non_english += 1;
+                    t4_print_word(data, e->size);
+                }
+            }
+        }
+
+        counts->num_total += jobs[t].num_total;
+        t4_bloom_stats_add(&counts->filter, &jobs[t].filter);
+        t4_stmap_free(&jobs[t].words);
+    }
+
+    t4_free(started);
+    t4_free(threads);
+    t4_free(jobs);
+}
+
+/**
+ * Same as t4_scan or t4_scan_parallel, but on the input as t4_stream_next hands it out, so only a few chunks of it
+ * are ever in memory. The words of a chunk are gone after it, so in and in_counts have to own their keys.
+ *
+ * @return false if reading failed, or the reader thread could not be started
+ */
+static bool t4_scan_stream(FILE * file, const t4_dict_t * dict, const size_t num_threads,
+                           t4_stset_t * in, t4_stmap_t * in_counts, t4_counts_t * counts) {
+    t4_stream_t stream;
+    if (!t4_stream_open(&stream, file)) {
+        return false;
+    }
+
+    t4_filebuf_t part = { .buf = NULL, .size = 0, .mapped = false, };
+    while (t4_stream_next(&stream, &part.buf, &part.size)) {
+        if (num_threads > 1) {
+            t4_scan_parallel(&part, dict, num_threads, in, in_counts, counts);
+        } else {
+            t4_scan(&part, dict, in, in_counts, counts);
+        }
+    }
+
+    const bool ok = !t4_stream_failed(&stream);
+    t4_stream_close(&stream);
+
+    return ok;
+}
+
+static void t4_print_top(const char * title, t4_topk_t * top, const t4_stmap_t * in) {
+    const size_t n = t4_topk_sort(top);
+
+    printf("\n%s:\n", title);
+    for (size_t i = 0; i < n; i++) {
+        const t4_stset_entry_t * e = in->set.entries + top->items[i].id;
+        printf("%10lu ", top->items[i].score);
+        t4_print_word(t4_stset_entry_data(&in->set, e), e->size);
+    }
+}
+
+/* One pass over the vocabulary, keeping only the k most frequent words and non-english words. */
+static void t4_report_top(const t4_stmap_t * in, size_t k) {
+    /* The heaps are allocated up front, and can never hold more than the distinct words anyway. */
+    k = k < t4_stmap_size(in) ? k : t4_stmap_size(in);
+
+    t4_topk_t top = t4_topk_new(k);
+    t4_topk_t top_non_english = t4_topk_new(k);
+
+    void * value;
+    for (size_t it = 0; t4_stmap_next(in, &it, &value) != NULL;) {
+        const t4_word_stats_t * stats = value;
+
+        /* Nothing is ever removed from in, so it - 1 is also where the entry is. */
+        t4_topk_push(&top, stats->count, it - 1);
+        if (!stats->english) {
+            t4_topk_push(&top_non_english, stats->count, it - 1);
+        }
+    }
+
+    t4_print_top("Most frequent words", &top, in);
+    t4_print_top("Most frequent non-english words", &top_non_english, in);
+
+    t4_topk_free(&top_non_english);
+    t4_topk_free(&top);
+}
+
+int main(const int argc, char * argv[]) {
+    /* -k N: count every word and report the N most frequent ones, 0 (the default) only lists non-english words. */
+    size_t top_k = 0;
+    /* -j N: scan the input with N threads, 0 picks one per CPU; the output is the same either way. */
+    size_t num_threads = 1;
+    /* -s: read the input in chunks instead of all at once, always done for stdin (-) and pipes. */
+    bool streaming = false;
+    /* -m: map the input read-only instead of reading it, see t4_map_file; -s takes precedence. */
+    bool mapping = false;
+    /* -d phf|tree|stset: the perfect hash or the search tree linked into t4, or a t4_stset mapped or built at startup. */
+    static const char * const dict_names[] = { [T4_DICT_KIND_PHF] = "phf", [T4_DICT_KIND_STREE] = "tree", [T4_DICT_KIND_STSET] = "stset", };
+    const char * dict_name = dict_names[T4_DICT_KIND_PHF];
+    /* -b N: look words up in a Bloom filter of N bits per dictionary word (up to 64) first, and report how it did; 0 (the default) has none. */
+    size_t bloom_bits = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "k:j:smd:b:")) != -1) {
+        if (opt == 's' || opt == 'm') {
+            streaming = streaming || opt == 's';
+            mapping = mapping || opt == 'm';
+            continue;
+        }
+
+        if (opt == 'd') {
+            dict_name = optarg;
+            continue;
+        }
+
+        char * end;
+        const size_t value = opt == '?' ? 0 : strtoul(optarg, &end, 10);
+
+        /* strtoul would also take "-1", wrapped around to a huge count, and leading blanks or a sign */
+        if (opt == '?' || *optarg < '0' || *optarg > '9' || *end != '\0') {
+            fprintf(stderr, "Usage: %s [-k N] [-j N] [-s] [-m] [-d phf|tree|stset] [-b N] [filename or - for stdin]\n", argv[0]);
+            return 1;
+        }
+
+        if (opt == 'k') {
+            top_k = value;
+        } else if (opt == 'b') {
+            /* Past this the false positives are long gone and more bits only cost memory, or overflow the size. */
+            bloom_bits = value < 64 ? value : 64;
+        } else {
+            num_threads = value != 0 ? value : (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+        }
+    }
+
+    t4_dict_kind_t dict_kind = T4_DICT_KIND_PHF;
+    while (dict_kind <= T4_DICT_KIND_STSET && strcmp(dict_name, dict_names[dict_kind]) != 0) {
+        dict_kind++;
+    }
+
+    if (optind != argc - 1 || dict_kind > T4_DICT_KIND_STSET) {
+        fprintf(stderr, "Usage: %s [-k N] [-j N] [-s] [-m] [-d phf|tree|stset] [-b N] [filename or - for stdin]\n", argv[0]);
         return 1;
     }
 
+    const char * path = argv[optind];
+
     const size_t alignment = t4_stset_get_alignment();
 
-    t4_filebuf_t f = t4_read_file(argv[1], alignment);
-    if (f.buf == NULL) {
-        fprintf(stderr, "Failed to open %s: %s", argv[1], strerror(errno));
+    t4_filebuf_t f = { .buf = NULL, .size = 0, .mapped = false, };
+    FILE * file = NULL;
+
+    /* Only regular files can be sized up front, everything else is streamed. */
+    struct stat st;
+    streaming = streaming || strcmp(path, "-") == 0 || (stat(path, &st) == 0 && !S_ISREG(st.st_mode));
+
+    if (streaming) {
+        file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    } else if (mapping) {
+        f = t4_map_file(path);
+    } else {
+        f = t4_read_file(path, alignment);
+    }
+
+    if (file == NULL && f.buf == NULL) {
+        fprintf(stderr, "Failed to open %s: %s", path, strerror(errno));
         return 1;
     }
 
-    // This doesn't really need any alignment.
-    t4_filebuf_t ef = t4_read_file("./sorted.bin", alignment);
-    assert(ef.buf != NULL);
+    t4_dict_t dict = { .kind = dict_kind, .set = NULL, .fold_case = f.mapped, .bloom = NULL, };
 
-    // Simply using 200k instead of 350k (no rehash or size increase) will be significantly faster
-    t4_stset_t eng = t4_stset_new(400000);
+    t4_stset_snapshot_t snapshot = { .map = NULL, };
+    t4_stset_t built = { 0 };
+
+    if (dict_kind == T4_DICT_KIND_PHF) {
+        if (!t4_phf_open(&dict.phf, t4_dict_phf_image, t4_dict_phf_image_end - t4_dict_phf_image)) {
+            fprintf(stderr, "The dictionary linked into %s is broken\n", argv[0]);
+            return 1;
+        }
+    } else if (dict_kind == T4_DICT_KIND_STREE) {
+        if (!t4_stree_open(&dict.tree, t4_dict_stree_image, t4_dict_stree_image_end - t4_dict_stree_image)) {
+            fprintf(stderr, "The dictionary linked into %s is broken\n", argv[0]);
+            return 1;
+        }
+    } else {
+        // Made by t4_mksnapshot, mapped instead of building the dictionary when there is one for this build.
+        // -m needs one made with -f, as every set folds case then.
+        const char * snapshot_path = f.mapped ? "./sorted_fold.snap" : "./sorted.snap";
+
+        enum t4_stset_snapshot_status status = t4_stset_snapshot_load(&snapshot, snapshot_path);
+        if (status == T4_STSET_SNAPSHOT_OK && snapshot.set.fold_case != f.mapped) {
+            t4_stset_snapshot_free(&snapshot);
+            status = T4_STSET_SNAPSHOT_MISMATCH;
+        }
 
-    {
-        char * start = ef.buf;
-        for (size_t i = 0; i < ef.size; i++) {
-            char * c = ef.buf + i;
-            if (*c == '\0') {
-                const u64 length = c - start;
-                if (length != 0) {
-                    t4_stset_insert_unchecked(&eng, start, length);
+        if (status == T4_STSET_SNAPSHOT_BAD_FORMAT) {
+            fprintf(stderr, "Ignoring %s, it is not a snapshot of this version of t4\n", snapshot_path);
+        } else if (status == T4_STSET_SNAPSHOT_MISMATCH) {
+            fprintf(stderr, "Ignoring %s, it was made for another build of t4\n", snapshot_path);
+        }
+
+        if (snapshot.map == NULL) {
+            // This doesn't really need any alignment.
+            t4_filebuf_t ef = t4_read_file("./sorted.bin", alignment);
+            assert(ef.buf != NULL);
+
+            // Simply using 200k instead of 350k (no rehash or size increase) will be significantly faster
+            // Owning, so sorted.bin does not have to stay around while the input is processed.
+            built = t4_stset_new_owning(400000);
+            // Has to fold like the sets of the input words, which only fold case when the input is mapped.
+            t4_stset_set_fold_case(&built, f.mapped);
+
+            char * start = ef.buf;
+            for (size_t i = 0; i < ef.size; i++) {
+                char * c = ef.buf + i;
+                if (*c == '\0') {
+                    const u64 length = c - start;
+                    if (length != 0) {
+                        t4_stset_insert_unchecked(&built, start, length);
+                    }
+                    start = c + 1;
                 }
-                start = c + 1;
             }
+
+            t4_free_aligned(ef.buf);
         }
+
+        dict.set = snapshot.map != NULL ? &snapshot.set : &built;
+    }
+
+    t4_bloom_t bloom = { .blocks = NULL, };
+    if (bloom_bits != 0) {
+        const size_t num_words = dict_kind == T4_DICT_KIND_STSET ? t4_stset_size(dict.set)
+                                 : dict_kind == T4_DICT_KIND_STREE ? t4_stree_size(&dict.tree) : dict.phf.num_keys;
+
+        // Folds like the dictionary, so the words it lets through are the ones the dictionary might have.
+        bloom = t4_bloom_new(num_words, (double)bloom_bits, f.mapped);
+        t4_dict_fill_bloom(&dict, &bloom);
+        dict.bloom = &bloom;
     }
 
     // TODO decide at runtime based on the size of the input file
-    t4_stset_t in = t4_stset_new(10000);
-
-    u64 non_english = 0;
-    u64 num_unique = 0;
-    u64 num_total = 0;
-
-    char * start = f.buf;
-    for (size_t i = 0; i < f.size; i++) {
-        char * c = f.buf + i;
-        if (!isalpha(*c)) {
-            const u64 length = c - start;
-
-            if (length != 0) {
-                num_total += 1;
-                const bool unique = t4_stset_try_insert(&in, start, length);
-
-                if (unique) {
-                    num_unique += 1;
-                    if (!t4_stset_exists(&eng, start, length)) {
-                        non_english += 1;
-                        printf("%.*s\n", (u32)length, start);
-                    }
-                }
-            }
+    t4_stset_t in = { 0 };
+    t4_stmap_t in_counts = { 0 };
 
-            start = c + 1;
-        } else {
-            *c = tolower(*c);
+    // Streamed chunks are reused, and words of a mapped file may be folded copies, so both need owning sets.
+    const bool owning = streaming || f.mapped;
+
+    if (top_k != 0) {
+        in_counts = owning ? t4_stmap_new_owning(10000, sizeof(t4_word_stats_t)) : t4_stmap_new(10000, sizeof(t4_word_stats_t));
+        t4_stset_set_fold_case(&in_counts.set, f.mapped);
+    } else {
+        in = owning ? t4_stset_new_owning(10000) : t4_stset_new(10000);
+        t4_stset_set_fold_case(&in, f.mapped);
+    }
+
+    t4_counts_t counts = { .non_english = 0, .num_unique = 0, .num_total = 0, .filter = { 0 }, };
+
+    if (streaming) {
+        if (!t4_scan_stream(file, &dict, num_threads, &in, top_k != 0 ? &in_counts : NULL, &counts)) {
+            fprintf(stderr, "Failed to read %s: %s\n", path, strerror(errno));
+            return 1;
         }
+
+        if (file != stdin) {
+            fclose(file);
+        }
+    } else if (num_threads > 1) {
+        t4_scan_parallel(&f, &dict, num_threads, &in, top_k != 0 ? &in_counts : NULL, &counts);
+    } else {
+        t4_scan(&f, &dict, &in, top_k != 0 ? &in_counts : NULL, &counts);
+    }
+
+    printf("\nTotal words: %lu\n", counts.num_total);
+    printf("Unique words: %lu\n", counts.num_unique);
+    printf("Number of non-english words: %lu\n", counts.non_english);
+
+    // On stderr, so the output stays the same with or without a filter.
+    if (dict.bloom != NULL) {
+        const t4_bloom_stats_t * filter = &counts.filter;
+        fprintf(stderr, "Bloom filter of %lu KiB: %lu lookups, %lu rejected, %lu let through and found, %lu let through "
+                "but not found (%.2f%% false positives)\n", bloom.num_blocks * sizeof(t4_bloom_block_t) / 1024, filter->lookups,
+                filter->rejected, filter->lookups - filter->rejected - filter->false_positives, filter->false_positives,
+                t4_bloom_false_positive_rate(filter) * 100.0);
     }
 
-    printf("\nTotal words: %lu\n", num_total);
-    printf("Unique words: %lu\n", num_unique);
-    printf("Number of non-english words: %lu\n", non_english);
+    if (top_k != 0) {
+        t4_report_top(&in_counts, top_k);
+        t4_stmap_free(&in_counts);
+    } else {
+        t4_stset_free(&in);
+    }
 
-    t4_stset_free(&in);
-    t4_stset_free(&eng);
+    if (dict.bloom != NULL) {
+        t4_bloom_free(&bloom);
+    }
 
-    t4_free_aligned(f.buf);
-    t4_free_aligned(ef.buf);
+    if (snapshot.map != NULL) {
+        t4_stset_snapshot_free(&snapshot);
+    } else if (dict.kind == T4_DICT_KIND_STSET) {
+        t4_stset_free(&built);
+    }
+
+    if (f.mapped && f.buf != NULL) {
+        t4_unmap_file(&f);
+    } else if (f.buf != NULL) {
+        t4_free_aligned(f.buf);
+    }
 
     return 0;
 }
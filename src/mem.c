@@ -30,6 +30,16 @@ void * t4_calloc_aligned_debug(const size_t size, const size_t alignment, const
     return ptr;
 }
 
+void * t4_realloc_debug(void * ptr, const size_t n, const size_t size, const char * file, const int line)
+{
+    ptr = realloc(ptr, n * size);
+    if (ptr == NULL) {
+        fprintf(stderr, "t4_realloc(n: %lu, size: %lu) failed: %s:%d\n", n, size, file, line);
+        abort();
+    }
+    return ptr;
+}
+
 #else
 
 #include <assert.h>
@@ -51,4 +61,11 @@ void * t4_calloc_aligned(size_t n, size_t size, size_t alignment)
     return ptr;
 }
 
+void * t4_realloc(void * ptr, size_t n, size_t size)
+{
+    ptr = realloc(ptr, n * size);
+    assert(ptr != NULL);
+    return ptr;
+}
+
 #endif /* T4_DEBUG */
@@ -0,0 +1,92 @@
+#include "t4/common.h"
+#include "t4/phf.h"
+#include "t4/mem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/*
+ * Builds the minimal perfect hash of a file of NUL separated words (sorted.bin) and writes out its image, see
+ * t4/phf.h. Run by the build, which links the image into t4 (CMakeLists.txt); it does not depend on the backend or
+ * the CPU, only on the byte order.
+ */
+
+int main(const int argc, char * argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <words> <image>\n", argv[0]);
+        return 1;
+    }
+
+    const char * words_path = argv[1];
+    const char * image_path = argv[2];
+
+    FILE * f = fopen(words_path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", words_path, strerror(errno));
+        return 1;
+    }
+
+    fseek(f, 0l, SEEK_END);
+    const size_t size = ftell(f);
+    fseek(f, 0l, SEEK_SET);
+
+    char * buf = t4_calloc(size + 1, 1);
+    const size_t read = fread(buf, 1, size, f);
+    fclose(f);
+
+    if (read != size) {
+        fprintf(stderr, "Failed to read %s\n", words_path);
+        return 1;
+    }
+
+    t4_stset_key_t * keys = t4_calloc(size / 2 + 1, sizeof(t4_stset_key_t));
+    size_t n = 0;
+
+    char * start = buf;
+    for (size_t i = 0; i <= size; i++) {
+        char * c = buf + i;
+        if (*c == '\0') {
+            if (c != start) {
+                keys[n++] = (t4_stset_key_t) { .data = start, .size = c - start, };
+            }
+            start = c + 1;
+        }
+    }
+
+    size_t image_size;
+    u8 * image = t4_phf_build(keys, n, &image_size);
+    if (image == NULL) {
+        fprintf(stderr, "Failed to build a perfect hash of %s, are there duplicate words?\n", words_path);
+        return 1;
+    }
+
+    /* Cheap enough to do every time, and nothing else would notice a broken image before t4 gets it wrong. */
+    t4_phf_t phf;
+    bool ok = t4_phf_open(&phf, image, image_size);
+    for (size_t i = 0; i < n && ok; i++) {
+        ok = t4_phf_exists(&phf, keys[i].data, keys[i].size);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "The perfect hash of %s does not find all of its words\n", words_path);
+        return 1;
+    }
+
+    FILE * out = fopen(image_path, "wb");
+    if (out == NULL || fwrite(image, 1, image_size, out) != image_size || fclose(out) != 0) {
+        fprintf(stderr, "Failed to write %s: %s\n", image_path, strerror(errno));
+        return 1;
+    }
+
+    const size_t overhead = phf.num_buckets * sizeof(u16) + (phf.num_slots - phf.num_keys) * sizeof(u32);
+    printf("%s: %lu words, %.2f bits per word for the function, %lu bytes in all\n", image_path, n,
+           n != 0 ? overhead * 8.0 / n : 0.0, image_size);
+
+    t4_free(image);
+    t4_free(keys);
+    t4_free(buf);
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "t4/common.h"
+#include "t4/stset.h"
+#include "t4/stset_snapshot.h"
+#include "t4/mem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+/*
+ * Builds the dictionary set t4 would build at startup from a file of NUL separated words (sorted.bin) and writes it
+ * out as a snapshot t4 maps instead, see t4/stset_snapshot.h. The snapshot only works with the backend this runs
+ * with, so run it on the machine (and build) t4 runs on, or pick the backend with T4_STSET_ISA.
+ *
+ * -f makes the set fold ASCII case, as the sets of t4 -m do; t4 looks for that one under another name.
+ */
+
+int main(const int argc, char * argv[]) {
+    bool fold_case = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f")) != -1) {
+        if (opt != 'f') {
+            fprintf(stderr, "Usage: %s [-f] <words> <snapshot>\n", argv[0]);
+            return 1;
+        }
+
+        fold_case = true;
+    }
+
+    if (optind != argc - 2) {
+        fprintf(stderr, "Usage: %s [-f] <words> <snapshot>\n", argv[0]);
+        return 1;
+    }
+
+    const char * words_path = argv[optind];
+    const char * snapshot_path = argv[optind + 1];
+
+    FILE * f = fopen(words_path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Failed to open %s: %s\n", words_path, strerror(errno));
+        return 1;
+    }
+
+    fseek(f, 0l, SEEK_END);
+    const size_t size = ftell(f);
+    fseek(f, 0l, SEEK_SET);
+
+    char * buf = t4_calloc(size + 1, 1);
+    const size_t read = fread(buf, 1, size, f);
+    fclose(f);
+
+    if (read != size) {
+        fprintf(stderr, "Failed to read %s\n", words_path);
+        return 1;
+    }
+
+    // Same as t4 itself, so the snapshot is laid out exactly like the set t4 would have built.
+    t4_stset_t set = t4_stset_new(400000);
+    t4_stset_set_fold_case(&set, fold_case);
+
+    char * start = buf;
+    for (size_t i = 0; i <= size; i++) {
+        char * c = buf + i;
+        if (*c == '\0') {
+            if (c != start) {
+                t4_stset_insert_unchecked(&set, start, c - start);
+            }
+            start = c + 1;
+        }
+    }
+
+    if (!t4_stset_snapshot_write(&set, snapshot_path)) {
+        fprintf(stderr, "Failed to write %s: %s\n", snapshot_path, strerror(errno));
+        return 1;
+    }
+
+    printf("%s: %lu words, %lu slots, group width %lu%s\n", snapshot_path, t4_stset_size(&set), set.capacity,
+           t4_stset_get_alignment(), fold_case ? ", folding case" : "");
+
+    t4_stset_free(&set);
+    t4_free(buf);
+
+    return 0;
+}
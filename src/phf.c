@@ -0,0 +1,277 @@
+#include "t4/phf.h"
+
+#include "t4/mem.h"
+
+#include <string.h>
+
+#define T4_PHF_MAGIC "t4phf"
+
+/* Seeds tried before giving up; with distinct keys the first one all but always works. */
+#define T4_PHF_ATTEMPTS 16
+
+/* Largest pilot a u16 holds */
+#define T4_PHF_MAX_PILOT UINT16_MAX
+
+typedef struct t4_phf_header {
+    char magic[8];
+    u32 version;
+    u32 reserved;
+    u64 seed;
+    u64 num_keys;
+    u64 num_slots;
+    u64 num_buckets;
+    u64 num_dense_buckets;
+    u64 keys_size;
+} t4_phf_header_t;
+
+/* Where every part of an image starts, and how large it is in all. */
+typedef struct t4_phf_layout {
+    size_t pilots;
+    size_t remap;
+    size_t offsets;
+    size_t keys;
+    size_t size;
+} t4_phf_layout_t;
+
+static t4_phf_layout_t t4_phf_layout(const t4_phf_header_t * h) {
+    t4_phf_layout_t res;
+
+    res.pilots = T4_ALIGN_UP(sizeof(t4_phf_header_t), 8);
+    res.remap = T4_ALIGN_UP(res.pilots + h->num_buckets * sizeof(u16), 8);
+    res.offsets = T4_ALIGN_UP(res.remap + (h->num_slots - h->num_keys) * sizeof(u32), 8);
+    res.keys = T4_ALIGN_UP(res.offsets + (h->num_keys + 1) * sizeof(u32), 8);
+    res.size = res.keys + h->keys_size;
+
+    return res;
+}
+
+/*
+ * One try at placing every key with the seed in phf, filling in its pilots and setting slots[i] to the final slot
+ * of key i. Fails if two keys of a bucket hash alike, or a bucket finds no pilot.
+ */
+static bool t4_phf_place(const t4_phf_t * phf, u16 * pilots, u32 * remap, const t4_stset_key_t * keys, u32 * slots) {
+    const size_t n = phf->num_keys;
+    const size_t m = phf->num_buckets;
+
+    bool ok = true;
+
+    u64 * hashes = t4_calloc(n, sizeof(u64));
+    u32 * bucket_of = t4_calloc(n, sizeof(u32));
+    /* Keys grouped by bucket, bucket b being order[start[b]] to order[start[b + 1]] */
+    size_t * start = t4_calloc(m + 2, sizeof(size_t));
+    u32 * order = t4_calloc(n, sizeof(u32));
+    u32 * buckets = t4_calloc(m, sizeof(u32));
+    u64 * taken = t4_calloc(T4_STSET_BITMAP_WORDS(phf->num_slots), sizeof(u64));
+
+    for (size_t i = 0; i < n; i++) {
+        hashes[i] = t4_phf_hash(phf, keys[i].data, keys[i].size);
+        bucket_of[i] = (u32)t4_phf_bucket(phf, hashes[i]);
+        start[bucket_of[i] + 2]++;
+    }
+
+    size_t largest = 0;
+    for (size_t b = 0; b < m; b++) {
+        largest = start[b + 2] > largest ? start[b + 2] : largest;
+        start[b + 2] += start[b + 1];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        order[start[bucket_of[i] + 1]++] = (u32)i;
+    }
+
+    /* Biggest buckets first, while there is the most room left for them. */
+    size_t * by_size = t4_calloc(largest + 2, sizeof(size_t));
+    for (size_t b = 0; b < m; b++) {
+        by_size[largest - (start[b + 1] - start[b]) + 1]++;
+    }
+    for (size_t s = 0; s <= largest; s++) {
+        by_size[s + 1] += by_size[s];
+    }
+    for (size_t b = 0; b < m; b++) {
+        buckets[by_size[largest - (start[b + 1] - start[b])]++] = (u32)b;
+    }
+
+    size_t * pos = t4_calloc(largest + 1, sizeof(size_t));
+
+    for (size_t k = 0; k < m && ok; k++) {
+        const size_t b = buckets[k];
+        const u32 * members = order + start[b];
+        const size_t size = start[b + 1] - start[b];
+
+        /* No pilot separates keys that hash alike. */
+        for (size_t i = 0; i < size && ok; i++) {
+            for (size_t j = i + 1; j < size && ok; j++) {
+                ok = hashes[members[i]] != hashes[members[j]];
+            }
+        }
+
+        size_t pilot = 0;
+        for (; ok && pilot <= T4_PHF_MAX_PILOT && size != 0; pilot++) {
+            size_t placed = 0;
+
+            for (; placed < size; placed++) {
+                const size_t p = t4_phf_position(hashes[members[placed]], pilot, phf->num_slots);
+                if (t4_stset_bitmap_get(taken, p)) {
+                    break;
+                }
+
+                taken[p / 64] |= 1llu << (p % 64);
+                pos[placed] = p;
+            }
+
+            if (placed == size) {
+                break;
+            }
+
+            for (size_t i = 0; i < placed; i++) {
+                taken[pos[i] / 64] &= ~(1llu << (pos[i] % 64));
+            }
+        }
+
+        ok = ok && pilot <= T4_PHF_MAX_PILOT;
+        pilots[b] = (u16)pilot;
+
+        for (size_t i = 0; i < size && ok; i++) {
+            slots[members[i]] = (u32)pos[i];
+        }
+    }
+
+    /* Every slot past the last key that was taken moves into a free one before it, in order. */
+    size_t hole = 0;
+    for (size_t p = n; p < phf->num_slots && ok; p++) {
+        if (!t4_stset_bitmap_get(taken, p)) {
+            continue;
+        }
+
+        while (t4_stset_bitmap_get(taken, hole)) {
+            hole++;
+        }
+
+        remap[p - n] = (u32)hole++;
+    }
+
+    for (size_t i = 0; i < n && ok; i++) {
+        slots[i] = slots[i] < n ? slots[i] : remap[slots[i] - n];
+    }
+
+    t4_free(pos);
+    t4_free(by_size);
+    t4_free(taken);
+    t4_free(buckets);
+    t4_free(order);
+    t4_free(start);
+    t4_free(bucket_of);
+    t4_free(hashes);
+
+    return ok;
+}
+
+u8 * t4_phf_build(const t4_stset_key_t * keys, const size_t n, size_t * size) {
+    size_t keys_size = 0;
+    for (size_t i = 0; i < n; i++) {
+        keys_size += keys[i].size;
+    }
+
+    if (n >= UINT32_MAX || keys_size > UINT32_MAX) {
+        return NULL;
+    }
+
+    /* Buckets of about 5 / log2(n) keys on average, and a few percent more slots than keys. */
+    size_t log2 = 1;
+    while (((size_t)1 << log2) < n) {
+        log2++;
+    }
+
+    const size_t num_buckets = 5 * n / log2 + 2;
+
+    t4_phf_header_t header = {
+        .magic = T4_PHF_MAGIC,
+        .version = T4_PHF_VERSION,
+        .reserved = 0,
+        .num_keys = n,
+        .num_slots = n + n / 32,
+        .num_buckets = num_buckets,
+        .num_dense_buckets = num_buckets * 3 / 10 + 1,
+        .keys_size = keys_size,
+    };
+
+    const t4_phf_layout_t layout = t4_phf_layout(&header);
+
+    u8 * image = t4_calloc(layout.size, 1);
+    u32 * slots = t4_calloc(n, sizeof(u32));
+
+    t4_phf_t phf = {
+        .num_keys = header.num_keys,
+        .num_slots = header.num_slots,
+        .num_buckets = header.num_buckets,
+        .num_dense_buckets = header.num_dense_buckets,
+    };
+
+    bool ok = false;
+    for (u64 attempt = 0; attempt < T4_PHF_ATTEMPTS && !ok; attempt++) {
+        /* Fixed, so the same keys always give the same image. */
+        phf.seed = _wymix(attempt ^ _wyp[2], _wyp[3]);
+
+        memset(image + layout.pilots, 0, layout.offsets - layout.pilots);
+        ok = t4_phf_place(&phf, (u16 *)(image + layout.pilots), (u32 *)(image + layout.remap), keys, slots);
+    }
+
+    if (!ok) {
+        t4_free(slots);
+        t4_free(image);
+        return NULL;
+    }
+
+    header.seed = phf.seed;
+    memcpy(image, &header, sizeof(header));
+
+    /* Keys are laid out in slot order, so each one ends where the one of the next slot starts. */
+    u32 * offsets = (u32 *)(image + layout.offsets);
+    for (size_t i = 0; i < n; i++) {
+        offsets[slots[i] + 1] = (u32)keys[i].size;
+    }
+    for (size_t s = 0; s < n; s++) {
+        offsets[s + 1] += offsets[s];
+    }
+    for (size_t i = 0; i < n; i++) {
+        memcpy(image + layout.keys + offsets[slots[i]], keys[i].data, keys[i].size);
+    }
+
+    t4_free(slots);
+
+    *size = layout.size;
+    return image;
+}
+
+bool t4_phf_open(t4_phf_t * self, const void * image, const size_t size) {
+    t4_phf_header_t h;
+    if (size < sizeof(h)) {
+        return false;
+    }
+
+    memcpy(&h, image, sizeof(h));
+
+    if (memcmp(h.magic, T4_PHF_MAGIC, sizeof(T4_PHF_MAGIC)) != 0 || h.version != T4_PHF_VERSION
+        || h.num_slots < h.num_keys || h.num_keys >= UINT32_MAX || h.num_slots > UINT32_MAX
+        || h.num_dense_buckets == 0 || h.num_dense_buckets >= h.num_buckets || h.num_buckets > UINT32_MAX
+        || h.keys_size > UINT32_MAX || t4_phf_layout(&h).size != size) {
+        return false;
+    }
+
+    const t4_phf_layout_t layout = t4_phf_layout(&h);
+    const u8 * base = image;
+
+    *self = (t4_phf_t) {
+        .seed = h.seed,
+        .num_keys = h.num_keys,
+        .num_slots = h.num_slots,
+        .num_buckets = h.num_buckets,
+        .num_dense_buckets = h.num_dense_buckets,
+        .pilots = (const u16 *)(base + layout.pilots),
+        .remap = (const u32 *)(base + layout.remap),
+        .offsets = (const u32 *)(base + layout.offsets),
+        .keys = base + layout.keys,
+    };
+
+    return true;
+}
@@ -1,32 +1,69 @@
-#include "t4/rtinfo.h"
-
-// TODO implement for windows
-t4_cpuid_t t4_get_cpuid(const u32 eax) {
-    t4_cpuid_t res = {
-        .eax = eax,
-        .ebx = 0x0,
-        .ecx = 0x0,
-        .edx = 0x0,
-    };
-
-    asm("cpuid\n\t" : "+a"(res.eax), "=b"(res.ebx), "+c"(res.ecx), "=d"(res.edx));
-
-    return res;
-}
-
-t4_cpu_features_t t4_get_cpu_features(void) {
-    t4_cpu_features_t features = {
-        .bmi1 = false,
-        .avx2 = false,
-        .sse4_2 = false,
-    };
-
-    t4_cpuid_t cpuid = t4_get_cpuid(0x7);
-    features.bmi1 = (cpuid.ebx & T4_FEATURE_BIT_BMI1) != 0;
-    features.avx2 = (cpuid.ebx & T4_FEATURE_BIT_AVX2) != 0;
-
-    cpuid = t4_get_cpuid(0x1);
-    features.sse4_2 = (cpuid.ecx & T4_FEATURE_BIT_SSE4_2) != 0;
-
-    return features;
-}
+#include "t4/rtinfo.h"
+
+// TODO implement for windows
+t4_cpuid_t t4_get_cpuid(const u32 eax) {
+    t4_cpuid_t res = {
+        .eax = eax,
+        .ebx = 0x0,
+        .ecx = 0x0,
+        .edx = 0x0,
+    };
+
+    asm("cpuid\n\t" : "+a"(res.eax), "=b"(res.ebx), "+c"(res.ecx), "=d"(res.edx));
+
+    return res;
+}
+
+static u64 t4_xgetbv(const u32 ecx) {
+    u32 eax, edx;
+
+    asm("xgetbv\n\t" : "=a"(eax), "=d"(edx) : "c"(ecx));
+
+    return ((u64)edx << 32) | eax;
+}
+
+t4_cpu_features_t t4_get_cpu_features(void) {
+    t4_cpu_features_t features = {
+        .bmi1 = false,
+        .avx2 = false,
+        .avx512f = false,
+        .avx512bw = false,
+        .sse4_2 = false,
+        .sse2 = false,
+    };
+
+    const u32 max_leaf = t4_get_cpuid(0x0).eax;
+
+    t4_cpuid_t cpuid = t4_get_cpuid(0x1);
+    features.sse4_2 = (cpuid.ecx & T4_FEATURE_BIT_SSE4_2) != 0;
+    features.sse2 = (cpuid.edx & T4_FEATURE_BIT_SSE2) != 0;
+
+    const bool osxsave = (cpuid.ecx & T4_FEATURE_BIT_OSXSAVE) != 0;
+
+    // Above the highest leaf, cpuid returns that of the highest one instead, which says nothing about leaf 7.
+    if (max_leaf < 0x7) {
+        return features;
+    }
+
+    cpuid = t4_get_cpuid(0x7);
+    features.bmi1 = (cpuid.ebx & T4_FEATURE_BIT_BMI1) != 0;
+    features.avx2 = (cpuid.ebx & T4_FEATURE_BIT_AVX2) != 0;
+    features.avx512f = (cpuid.ebx & T4_FEATURE_BIT_AVX512F) != 0;
+    features.avx512bw = (cpuid.ebx & T4_FEATURE_BIT_AVX512BW) != 0;
+
+    // Only usable if the OS saves their registers too.
+    const u64 xcr0 = osxsave ? t4_xgetbv(0) : 0;
+    const u64 avx_state = T4_XCR0_BIT_SSE | T4_XCR0_BIT_AVX;
+    const u64 avx512_state = avx_state | T4_XCR0_BIT_OPMASK | T4_XCR0_BIT_ZMM_HI256 | T4_XCR0_BIT_HI16_ZMM;
+
+    if ((xcr0 & avx_state) != avx_state) {
+        features.avx2 = false;
+    }
+
+    if ((xcr0 & avx512_state) != avx512_state) {
+        features.avx512f = false;
+        features.avx512bw = false;
+    }
+
+    return features;
+}
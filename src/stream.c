@@ -0,0 +1,150 @@
+#include "t4/stream.h"
+
+#include "t4/tokenize.h"
+#include "t4/mem.h"
+
+#include <string.h>
+#include <errno.h>
+
+static void * t4_stream_read(void * arg) {
+    t4_stream_t * self = arg;
+
+    for (size_t i = 0;; i ^= 1) {
+        pthread_mutex_lock(&self->lock);
+        while (self->ready[i] && !self->closing) {
+            pthread_cond_wait(&self->cond, &self->lock);
+        }
+        const bool closing = self->closing;
+        pthread_mutex_unlock(&self->lock);
+
+        if (closing) {
+            return NULL;
+        }
+
+        /* fread keeps reading a pipe until the chunk is full, so a short read is always the end. */
+        const size_t read = fread(self->bufs[i] + T4_STREAM_CHUNK, 1, T4_STREAM_CHUNK, self->file);
+        const bool last = read < T4_STREAM_CHUNK;
+
+        pthread_mutex_lock(&self->lock);
+        self->filled[i] = read;
+        self->last[i] = last;
+        self->failed |= ferror(self->file) != 0;
+        self->ready[i] = true;
+        pthread_cond_broadcast(&self->cond);
+        pthread_mutex_unlock(&self->lock);
+
+        if (last) {
+            return NULL;
+        }
+    }
+}
+
+bool t4_stream_open(t4_stream_t * self, FILE * file) {
+    *self = (t4_stream_t) {
+        .file = file,
+        .filled = { 0, 0 },
+        .ready = { false, false },
+        .last = { false, false },
+        /* So the first t4_stream_next takes buffer 0. */
+        .current = 1,
+        .tail = NULL,
+        .tail_size = 0,
+        .done = false,
+        .failed = false,
+        .closing = false,
+    };
+
+    for (size_t i = 0; i < 2; i++) {
+        self->bufs[i] = t4_calloc_aligned(2 * T4_STREAM_CHUNK, T4_PAGE_SIZE);
+    }
+
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->cond, NULL);
+
+    const int err = pthread_create(&self->reader, NULL, t4_stream_read, self);
+    if (err != 0) {
+        pthread_cond_destroy(&self->cond);
+        pthread_mutex_destroy(&self->lock);
+
+        for (size_t i = 0; i < 2; i++) {
+            t4_free_aligned(self->bufs[i]);
+        }
+
+        errno = err;
+        return false;
+    }
+
+    return true;
+}
+
+void t4_stream_close(t4_stream_t * self) {
+    pthread_mutex_lock(&self->lock);
+    self->closing = true;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->lock);
+
+    pthread_join(self->reader, NULL);
+
+    pthread_cond_destroy(&self->cond);
+    pthread_mutex_destroy(&self->lock);
+
+    for (size_t i = 0; i < 2; i++) {
+        t4_free_aligned(self->bufs[i]);
+    }
+}
+
+bool t4_stream_next(t4_stream_t * self, char ** data, size_t * size) {
+    if (self->done) {
+        return false;
+    }
+
+    const size_t prev = self->current;
+    const size_t next = prev ^ 1;
+
+    pthread_mutex_lock(&self->lock);
+    while (!self->ready[next]) {
+        pthread_cond_wait(&self->cond, &self->lock);
+    }
+    pthread_mutex_unlock(&self->lock);
+
+    /* The reader never writes in front of a chunk, so the tail can go there while the previous one is refilled. */
+    char * chunk = self->bufs[next] + T4_STREAM_CHUNK;
+    memcpy(chunk - self->tail_size, self->tail, self->tail_size);
+
+    pthread_mutex_lock(&self->lock);
+    /* Nothing was handed out before the first call, and the reader may already have filled the other buffer. */
+    if (self->tail != NULL) {
+        self->ready[prev] = false;
+        pthread_cond_broadcast(&self->cond);
+    }
+    const bool failed = self->failed;
+    pthread_mutex_unlock(&self->lock);
+
+    if (failed) {
+        self->done = true;
+        return false;
+    }
+
+    char * start = chunk - self->tail_size;
+    const size_t total = self->tail_size + self->filled[next];
+
+    size_t split = total;
+    if (!self->last[next]) {
+        while (split > 0 && ((u8)start[split - 1] >= 0x80 || t4_is_ascii_letter(start[split - 1]))) {
+            split--;
+        }
+
+        /* No separator anywhere, the carried bytes are given out as they are so the tail fits in front again. */
+        split = split != 0 ? split : self->tail_size;
+    }
+
+    self->current = next;
+    self->tail = start + split;
+    self->tail_size = total - split;
+    self->done = self->last[next];
+
+    *data = start;
+    *size = split;
+
+    return true;
+}
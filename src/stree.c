@@ -0,0 +1,206 @@
+#include "t4/stree.h"
+
+#include "t4/mem.h"
+#include "t4/rtinfo.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The layers are those of the S+ tree on algorithmica.org (Algorithms for Modern Hardware, "Search Trees"): a node
+ * of layer h + 1 holds, for each of its B + 1 children but the first, the least prefix below that child, so
+ * counting the prefixes of a node less than the one looked up picks the child to go on with. In layer 0, the keys
+ * themselves, that count ends at the first key with at least that prefix.
+ */
+
+#define T4_STREE_MAGIC "t4stree"
+
+typedef struct t4_stree_header {
+    char magic[8];
+    u32 version;
+    u32 reserved;
+    u64 num_keys;
+    u64 keys_size;
+} t4_stree_header_t;
+
+/* Nodes of the layer holding n prefixes; there is always one, however empty. */
+static size_t t4_stree_blocks(const size_t n) {
+    return n > T4_STREE_B ? (n + T4_STREE_B - 1) / T4_STREE_B : 1;
+}
+
+/* Prefixes of the layer above one of n, one for every child but the first of each of its nodes */
+static size_t t4_stree_prev_keys(const size_t n) {
+    return (t4_stree_blocks(n) + T4_STREE_B) / (T4_STREE_B + 1) * T4_STREE_B;
+}
+
+/* Fills in the height and layers of self for its num_keys, and returns the size of the tree in prefixes. */
+static size_t t4_stree_shape(t4_stree_t * self) {
+    size_t n = self->num_keys;
+    size_t offset = 0;
+
+    self->height = 0;
+    for (;;) {
+        self->layers[self->height++] = offset;
+        offset += t4_stree_blocks(n) * T4_STREE_B;
+
+        if (n <= T4_STREE_B) {
+            return offset;
+        }
+
+        n = t4_stree_prev_keys(n);
+    }
+}
+
+/* Where every part of an image starts, and how large it is in all. */
+typedef struct t4_stree_layout {
+    size_t tree;
+    size_t offsets;
+    size_t keys;
+    size_t size;
+} t4_stree_layout_t;
+
+static t4_stree_layout_t t4_stree_layout(const t4_stree_header_t * h, const size_t tree_size) {
+    t4_stree_layout_t res;
+
+    res.tree = T4_ALIGN_UP(sizeof(t4_stree_header_t), 64);
+    res.offsets = T4_ALIGN_UP(res.tree + tree_size * sizeof(i64), 64);
+    res.keys = T4_ALIGN_UP(res.offsets + (h->num_keys + 1) * sizeof(u32), 64);
+    res.size = res.keys + h->keys_size;
+
+    return res;
+}
+
+static int t4_stree_key_cmp(const void * a, const void * b) {
+    const t4_stset_key_t * x = a;
+    const t4_stset_key_t * y = b;
+
+    return t4_stree_compare(x->data, x->size, y->data, y->size, false);
+}
+
+u8 * t4_stree_build(const t4_stset_key_t * keys, const size_t n, size_t * size) {
+    size_t keys_size = 0;
+    for (size_t i = 0; i < n; i++) {
+        keys_size += keys[i].size;
+    }
+
+    if (n >= UINT32_MAX || keys_size > UINT32_MAX) {
+        return NULL;
+    }
+
+    t4_stset_key_t * sorted = t4_calloc(n + 1, sizeof(t4_stset_key_t));
+    memcpy(sorted, keys, n * sizeof(t4_stset_key_t));
+    qsort(sorted, n, sizeof(t4_stset_key_t), t4_stree_key_cmp);
+
+    for (size_t i = 0; i < n; i++) {
+        if (t4_stree_prefix(sorted[i].data, sorted[i].size) == T4_STREE_NONE_PREFIX
+            || (i != 0 && t4_stree_key_cmp(sorted + i - 1, sorted + i) == 0)) {
+            t4_free(sorted);
+            return NULL;
+        }
+    }
+
+    t4_stree_header_t header = {
+        .magic = T4_STREE_MAGIC,
+        .version = T4_STREE_VERSION,
+        .reserved = 0,
+        .num_keys = n,
+        .keys_size = keys_size,
+    };
+
+    t4_stree_t shape = { .num_keys = n, };
+    const size_t tree_size = t4_stree_shape(&shape);
+    const t4_stree_layout_t layout = t4_stree_layout(&header, tree_size);
+
+    u8 * image = t4_calloc(layout.size, 1);
+    memcpy(image, &header, sizeof(header));
+
+    i64 * tree = (i64 *)(image + layout.tree);
+    const size_t bottom_size = shape.height > 1 ? shape.layers[1] : tree_size;
+    for (size_t i = 0; i < bottom_size; i++) {
+        tree[i] = i < n ? t4_stree_prefix(sorted[i].data, sorted[i].size) : T4_STREE_NONE_PREFIX;
+    }
+
+    /* Prefix j of node k of layer h is the least one below child j + 1 of that node: its leftmost key in layer 0. */
+    for (size_t h = 1; h < shape.height; h++) {
+        const size_t layer_size = (h + 1 < shape.height ? shape.layers[h + 1] : tree_size) - shape.layers[h];
+
+        for (size_t i = 0; i < layer_size; i++) {
+            size_t k = i / T4_STREE_B * (T4_STREE_B + 1) + i % T4_STREE_B + 1;
+            for (size_t l = 1; l < h; l++) {
+                k *= T4_STREE_B + 1;
+            }
+
+            tree[shape.layers[h] + i] = k * T4_STREE_B < n ? tree[k * T4_STREE_B] : T4_STREE_NONE_PREFIX;
+        }
+    }
+
+    u32 * offsets = (u32 *)(image + layout.offsets);
+    for (size_t i = 0; i < n; i++) {
+        offsets[i + 1] = offsets[i] + (u32)sorted[i].size;
+        memcpy(image + layout.keys + offsets[i], sorted[i].data, sorted[i].size);
+    }
+
+    t4_free(sorted);
+
+    *size = layout.size;
+    return image;
+}
+
+bool t4_stree_open(t4_stree_t * self, const void * image, const size_t size) {
+    t4_stree_header_t h;
+    if (size < sizeof(h)) {
+        return false;
+    }
+
+    memcpy(&h, image, sizeof(h));
+
+    if (memcmp(h.magic, T4_STREE_MAGIC, sizeof(T4_STREE_MAGIC)) != 0 || h.version != T4_STREE_VERSION
+        || h.num_keys >= UINT32_MAX || h.keys_size > UINT32_MAX) {
+        return false;
+    }
+
+    *self = (t4_stree_t) { .num_keys = h.num_keys, };
+
+    const size_t tree_size = t4_stree_shape(self);
+    const t4_stree_layout_t layout = t4_stree_layout(&h, tree_size);
+    if (layout.size != size) {
+        return false;
+    }
+
+    const u8 * base = image;
+    self->tree = (const i64 *)(base + layout.tree);
+    self->offsets = (const u32 *)(base + layout.offsets);
+    self->keys = base + layout.keys;
+    self->search = t4_internal_stree_search_scalar;
+
+#if defined(__AVX2__)
+    self->search = t4_internal_stree_search_avx2;
+#else
+    const t4_cpu_features_t features = t4_get_cpu_features();
+    if (features.avx2) {
+        self->search = t4_internal_stree_search_avx2;
+    }
+#endif
+
+    return true;
+}
+
+/* t4_stree_descend for a batch, level by level, so the loads of different keys overlap. */
+void t4_internal_stree_search_scalar(const t4_stree_t * self, const i64 * prefixes, const size_t n, size_t * res) {
+    for (size_t i = 0; i < n; i++) {
+        res[i] = 0;
+    }
+
+    /* res[i] is where the node of key i starts within the layer. */
+    for (size_t h = self->height - 1; h > 0; h--) {
+        const i64 * layer = self->tree + self->layers[h];
+
+        for (size_t i = 0; i < n; i++) {
+            res[i] = res[i] * (T4_STREE_B + 1) + t4_stree_rank(layer + res[i], prefixes[i]) * T4_STREE_B;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        res[i] += t4_stree_rank(self->tree + res[i], prefixes[i]);
+    }
+}
@@ -0,0 +1,31 @@
+#include "t4/stree.h"
+
+#include <immintrin.h>
+
+/* Prefixes of the node less than x; they are in order, so these are its first ones. Two compares for the whole node. */
+static inline size_t t4_stree_rank_avx2(const i64 * node, const __m256i x) {
+    const __m256i lo = _mm256_cmpgt_epi64(x, _mm256_loadu_si256((const __m256i *)node));
+    const __m256i hi = _mm256_cmpgt_epi64(x, _mm256_loadu_si256((const __m256i *)(node + 4)));
+    const u32 less = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(lo)) | (u32)_mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4;
+
+    return (size_t)__builtin_ctz(~less);
+}
+
+/* Same as t4_internal_stree_search_scalar. */
+void t4_internal_stree_search_avx2(const t4_stree_t * self, const i64 * prefixes, const size_t n, size_t * res) {
+    for (size_t i = 0; i < n; i++) {
+        res[i] = 0;
+    }
+
+    for (size_t h = self->height - 1; h > 0; h--) {
+        const i64 * layer = self->tree + self->layers[h];
+
+        for (size_t i = 0; i < n; i++) {
+            res[i] = res[i] * (T4_STREE_B + 1) + t4_stree_rank_avx2(layer + res[i], _mm256_set1_epi64x(prefixes[i])) * T4_STREE_B;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        res[i] += t4_stree_rank_avx2(self->tree + res[i], _mm256_set1_epi64x(prefixes[i]));
+    }
+}
@@ -0,0 +1,36 @@
+#include "t4/stset.h"
+
+#include "t4/internal/stset_group_avx2.h"
+
+#define T4_STSET_BACKEND avx2
+#include "t4/internal/stset_impl.h"
+
+const struct t4_internal_stset_vtable t4_internal_stset_vtable_avx2 = {
+    .get_alignment = t4_stset_get_alignment_avx2,
+
+    .new = t4_stset_new_avx2,
+    .free = t4_stset_free_avx2,
+
+    .insert_unchecked = t4_stset_insert_unchecked_avx2,
+    .try_insert = t4_stset_try_insert_avx2,
+
+    .exists = t4_stset_exists_avx2,
+
+    .remove = t4_stset_remove_avx2,
+
+    .insert_unchecked_with_hash = t4_stset_insert_unchecked_with_hash_avx2,
+    .try_insert_with_hash = t4_stset_try_insert_with_hash_avx2,
+    .exists_with_hash = t4_stset_exists_with_hash_avx2,
+    .remove_with_hash = t4_stset_remove_with_hash_avx2,
+
+    .try_insert_exists = t4_stset_try_insert_exists_avx2,
+
+    .try_insert_batch = t4_stset_try_insert_batch_avx2,
+    .exists_batch = t4_stset_exists_batch_avx2,
+    .try_insert_exists_batch = t4_stset_try_insert_exists_batch_avx2,
+
+    .probe_length = t4_stset_probe_length_avx2,
+
+    .map_upsert = t4_stset_map_upsert_avx2,
+    .map_get = t4_stset_map_get_avx2,
+};
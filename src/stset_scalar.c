@@ -0,0 +1,36 @@
+#include "t4/stset.h"
+
+#include "t4/internal/stset_group_scalar.h"
+
+#define T4_STSET_BACKEND scalar
+#include "t4/internal/stset_impl.h"
+
+const struct t4_internal_stset_vtable t4_internal_stset_vtable_scalar = {
+    .get_alignment = t4_stset_get_alignment_scalar,
+
+    .new = t4_stset_new_scalar,
+    .free = t4_stset_free_scalar,
+
+    .insert_unchecked = t4_stset_insert_unchecked_scalar,
+    .try_insert = t4_stset_try_insert_scalar,
+
+    .exists = t4_stset_exists_scalar,
+
+    .remove = t4_stset_remove_scalar,
+
+    .insert_unchecked_with_hash = t4_stset_insert_unchecked_with_hash_scalar,
+    .try_insert_with_hash = t4_stset_try_insert_with_hash_scalar,
+    .exists_with_hash = t4_stset_exists_with_hash_scalar,
+    .remove_with_hash = t4_stset_remove_with_hash_scalar,
+
+    .try_insert_exists = t4_stset_try_insert_exists_scalar,
+
+    .try_insert_batch = t4_stset_try_insert_batch_scalar,
+    .exists_batch = t4_stset_exists_batch_scalar,
+    .try_insert_exists_batch = t4_stset_try_insert_exists_batch_scalar,
+
+    .probe_length = t4_stset_probe_length_scalar,
+
+    .map_upsert = t4_stset_map_upsert_scalar,
+    .map_get = t4_stset_map_get_scalar,
+};
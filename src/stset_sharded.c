@@ -0,0 +1,118 @@
+#include "t4/stset_sharded.h"
+
+#include "t4/mem.h"
+
+#include <immintrin.h>
+#include <sched.h>
+
+/* Spins this many times before giving the CPU away, in case the holder was preempted. */
+#define T4_SHARD_SPIN 64
+
+static void t4_shard_lock(t4_stset_shard_t * shard) {
+    for (;;) {
+        if (!atomic_exchange_explicit(&shard->locked, true, memory_order_acquire)) {
+            return;
+        }
+
+        /* Wait on a plain load, so the cache line is only written once it looks free. */
+        for (u32 spins = 0; atomic_load_explicit(&shard->locked, memory_order_relaxed); spins++) {
+            if (spins < T4_SHARD_SPIN) {
+                _mm_pause();
+            } else {
+                sched_yield();
+            }
+        }
+    }
+}
+
+static void t4_shard_unlock(t4_stset_shard_t * shard) {
+    atomic_store_explicit(&shard->locked, false, memory_order_release);
+}
+
+static t4_stset_shard_t * t4_shard_of(t4_stset_sharded_t * self, const u64 hash) {
+    return self->shards + ((hash >> 32) & (self->num_shards - 1));
+}
+
+static t4_stset_sharded_t t4_stset_sharded_new_impl(const size_t capacity, size_t num_shards, const bool owning) {
+    num_shards = num_shards <= 1 ? 1 : (size_t)1 << (64 - __builtin_clzll(num_shards - 1));
+
+    t4_stset_sharded_t res = {
+        .shards = t4_calloc_aligned(num_shards * sizeof(t4_stset_shard_t), alignof(t4_stset_shard_t)),
+        .num_shards = num_shards,
+    };
+
+    for (size_t i = 0; i < num_shards; i++) {
+        atomic_init(&res.shards[i].locked, false);
+        res.shards[i].set = owning ? t4_stset_new_owning(capacity / num_shards) : t4_stset_new(capacity / num_shards);
+    }
+
+    return res;
+}
+
+t4_stset_sharded_t t4_stset_sharded_new(const size_t capacity, const size_t num_shards) {
+    return t4_stset_sharded_new_impl(capacity, num_shards, false);
+}
+
+t4_stset_sharded_t t4_stset_sharded_new_owning(const size_t capacity, const size_t num_shards) {
+    return t4_stset_sharded_new_impl(capacity, num_shards, true);
+}
+
+void t4_stset_sharded_free(t4_stset_sharded_t * self) {
+    for (size_t i = 0; i < self->num_shards; i++) {
+        t4_stset_free(&self->shards[i].set);
+    }
+
+    t4_free_aligned(self->shards);
+    self->num_shards = 0;
+}
+
+bool t4_stset_sharded_try_insert(t4_stset_sharded_t * self, void * data, const size_t data_size) {
+    /* Hashed before taking the lock, so only the probe itself is serialised. */
+    const u64 hash = t4_stset_hash(data, data_size);
+    t4_stset_shard_t * shard = t4_shard_of(self, hash);
+
+    t4_shard_lock(shard);
+    const bool inserted = t4_stset_try_insert_with_hash(&shard->set, hash, data, data_size);
+    t4_shard_unlock(shard);
+
+    return inserted;
+}
+
+bool t4_stset_sharded_exists(t4_stset_sharded_t * self, const void * data, const size_t data_size) {
+    const u64 hash = t4_stset_hash(data, data_size);
+    t4_stset_shard_t * shard = t4_shard_of(self, hash);
+
+    /* Readers lock too, a concurrent insert may be growing the shard. */
+    t4_shard_lock(shard);
+    const bool found = t4_stset_exists_with_hash(&shard->set, hash, data, data_size);
+    t4_shard_unlock(shard);
+
+    return found;
+}
+
+u32 t4_stset_sharded_try_insert_exists(t4_stset_sharded_t * self, const t4_stset_t * other, void * data, const size_t data_size) {
+    /* The shards never fold case, so neither may other for the hash to be shared. */
+    t4_debug_assert(!other->fold_case);
+
+    const u64 hash = t4_stset_hash(data, data_size);
+    t4_stset_shard_t * shard = t4_shard_of(self, hash);
+
+    t4_shard_lock(shard);
+    const bool inserted = t4_stset_try_insert_with_hash(&shard->set, hash, data, data_size);
+    t4_shard_unlock(shard);
+
+    if (!inserted) {
+        return 0;
+    }
+
+    return T4_STSET_INSERTED | (t4_stset_exists_with_hash(other, hash, data, data_size) ? T4_STSET_IN_OTHER : 0);
+}
+
+size_t t4_stset_sharded_size(const t4_stset_sharded_t * self) {
+    size_t size = 0;
+    for (size_t i = 0; i < self->num_shards; i++) {
+        size += t4_stset_size(&self->shards[i].set);
+    }
+
+    return size;
+}
@@ -0,0 +1,253 @@
+#include "t4/stset_snapshot.h"
+
+#include "t4/mem.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Only whole sets are dealt with here, nothing is probed, so this works with any backend; the one snapshots are
+ * checked against is whichever t4_stset_get_alignment reports.
+ */
+
+#define T4_STSET_SNAPSHOT_MAGIC "t4stset"
+
+/* Flags of the header */
+#define T4_STSET_SNAPSHOT_FOLD_CASE (1u << 0)
+#define T4_STSET_SNAPSHOT_LINEAR_PROBING (1u << 1)
+
+/* Every offset is from the start of the file. */
+typedef struct t4_stset_snapshot_header {
+    char magic[8];
+    u32 version;
+    u32 entry_size;
+    u32 group_width;
+    u32 flags;
+    u64 seed;
+    u64 capacity;
+    u64 num_entries;
+    u64 metadata_offset;
+    u64 index_offset;
+    u64 entries_offset;
+    u64 keys_offset;
+    u64 keys_size;
+} t4_stset_snapshot_header_t;
+
+/* Seed of the snapshots loaded so far, which every set hashes with since the first one */
+static bool t4_stset_snapshot_seeded = false;
+static u64 t4_stset_snapshot_seed = 0;
+
+static u32 t4_stset_snapshot_flags(const bool fold_case) {
+    u32 flags = fold_case ? T4_STSET_SNAPSHOT_FOLD_CASE : 0;
+
+#if defined(T4_STSET_LINEAR_PROBING)
+    flags |= T4_STSET_SNAPSHOT_LINEAR_PROBING;
+#endif
+
+    return flags;
+}
+
+static bool t4_stset_snapshot_put(FILE * f, u64 * pos, const void * data, const size_t size) {
+    *pos += size;
+    return fwrite(data, 1, size, f) == size;
+}
+
+/* Writes zeroes up to where the next part starts, see T4_STSET_SNAPSHOT_ALIGN. */
+static bool t4_stset_snapshot_pad(FILE * f, u64 * pos) {
+    static const u8 zeroes[T4_STSET_SNAPSHOT_ALIGN] = { 0 };
+
+    return t4_stset_snapshot_put(f, pos, zeroes, T4_ALIGN_UP(*pos, T4_STSET_SNAPSHOT_ALIGN) - *pos);
+}
+
+static bool t4_stset_snapshot_write_to(const t4_stset_t * set, FILE * f) {
+    t4_stset_snapshot_header_t header = {
+        .magic = T4_STSET_SNAPSHOT_MAGIC,
+        .version = T4_STSET_SNAPSHOT_VERSION,
+        .entry_size = sizeof(t4_stset_entry_t),
+        .group_width = (u32)t4_stset_get_alignment(),
+        .flags = t4_stset_snapshot_flags(set->fold_case),
+        .seed = t4_internal_stset_seed,
+        .capacity = set->capacity,
+        .num_entries = set->num_entries,
+        .keys_size = 0,
+    };
+
+    for (size_t k = 0; k < set->num_entries; k++) {
+        header.keys_size += set->entries[k].size > T4_STSET_INLINE ? set->entries[k].size : 0;
+    }
+
+    /* Every part starts aligned, the header is followed by each of them in turn. */
+    header.metadata_offset = T4_ALIGN_UP(sizeof(header), T4_STSET_SNAPSHOT_ALIGN);
+    header.index_offset = T4_ALIGN_UP(header.metadata_offset + set->capacity, T4_STSET_SNAPSHOT_ALIGN);
+    header.entries_offset = T4_ALIGN_UP(header.index_offset + set->capacity * sizeof(u32), T4_STSET_SNAPSHOT_ALIGN);
+    header.keys_offset = T4_ALIGN_UP(header.entries_offset + set->num_entries * sizeof(t4_stset_entry_t), T4_STSET_SNAPSHOT_ALIGN);
+
+    u64 pos = 0;
+    if (!t4_stset_snapshot_put(f, &pos, &header, sizeof(header)) || !t4_stset_snapshot_pad(f, &pos)
+        || !t4_stset_snapshot_put(f, &pos, set->metadata, set->capacity) || !t4_stset_snapshot_pad(f, &pos)
+        || !t4_stset_snapshot_put(f, &pos, set->index, set->capacity * sizeof(u32)) || !t4_stset_snapshot_pad(f, &pos)) {
+        return false;
+    }
+
+    /* Longer keys point into the blob, in the order of their entries. */
+    u64 offset = 0;
+    for (size_t k = 0; k < set->num_entries; k++) {
+        t4_stset_entry_t e = set->entries[k];
+
+        if (e.size > T4_STSET_INLINE) {
+            e.data = (void *)(uintptr_t)offset;
+            offset += e.size;
+        }
+
+        if (!t4_stset_snapshot_put(f, &pos, &e, sizeof(e))) {
+            return false;
+        }
+    }
+
+    if (!t4_stset_snapshot_pad(f, &pos)) {
+        return false;
+    }
+
+    for (size_t k = 0; k < set->num_entries; k++) {
+        const t4_stset_entry_t * e = set->entries + k;
+
+        if (e->size > T4_STSET_INLINE && !t4_stset_snapshot_put(f, &pos, t4_stset_entry_data(set, e), e->size)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool t4_stset_snapshot_write(const t4_stset_t * set, const char * path) {
+    /* Removed keys would still be in entries, and values are not written at all. */
+    assert(set->size == set->num_entries && set->value_size == 0);
+
+    const size_t length = strlen(path);
+    char * tmp = t4_calloc(length + sizeof(".tmp"), 1);
+    memcpy(tmp, path, length);
+    memcpy(tmp + length, ".tmp", sizeof(".tmp"));
+
+    FILE * f = fopen(tmp, "wb");
+    bool ok = f != NULL;
+
+    if (ok) {
+        ok = t4_stset_snapshot_write_to(set, f);
+        ok = fclose(f) == 0 && ok;
+        ok = ok && rename(tmp, path) == 0;
+
+        if (!ok) {
+            remove(tmp);
+        }
+    }
+
+    t4_free(tmp);
+
+    return ok;
+}
+
+/* Whether the part of the file at offset, size bytes long, is aligned and within the file. */
+static bool t4_stset_snapshot_part_ok(const u64 offset, const u64 size, const size_t file_size) {
+    return offset % T4_STSET_SNAPSHOT_ALIGN == 0 && offset <= file_size && size <= file_size - offset;
+}
+
+static enum t4_stset_snapshot_status t4_stset_snapshot_check(const t4_stset_snapshot_header_t * h, const size_t file_size) {
+    if (memcmp(h->magic, T4_STSET_SNAPSHOT_MAGIC, sizeof(h->magic)) != 0 || h->version != T4_STSET_SNAPSHOT_VERSION
+        || h->entry_size != sizeof(t4_stset_entry_t)) {
+        return T4_STSET_SNAPSHOT_BAD_FORMAT;
+    }
+
+    /* A power of two no smaller than a group, with every entry in a slot; the parts are then no larger than this. */
+    if (h->capacity == 0 || (h->capacity & (h->capacity - 1)) != 0 || h->capacity < h->group_width
+        || h->num_entries > h->capacity || h->capacity > file_size
+        || !t4_stset_snapshot_part_ok(h->metadata_offset, h->capacity, file_size)
+        || !t4_stset_snapshot_part_ok(h->index_offset, h->capacity * sizeof(u32), file_size)
+        || !t4_stset_snapshot_part_ok(h->entries_offset, h->num_entries * sizeof(t4_stset_entry_t), file_size)
+        || !t4_stset_snapshot_part_ok(h->keys_offset, h->keys_size, file_size)) {
+        return T4_STSET_SNAPSHOT_BAD_FORMAT;
+    }
+
+    /* This also initialises the backend and its seed, which must not happen after the seed is replaced below. */
+    if (h->group_width != t4_stset_get_alignment()
+        || (h->flags & T4_STSET_SNAPSHOT_LINEAR_PROBING) != (t4_stset_snapshot_flags(false) & T4_STSET_SNAPSHOT_LINEAR_PROBING)
+        || (t4_stset_snapshot_seeded && h->seed != t4_stset_snapshot_seed)) {
+        return T4_STSET_SNAPSHOT_MISMATCH;
+    }
+
+    return T4_STSET_SNAPSHOT_OK;
+}
+
+enum t4_stset_snapshot_status t4_stset_snapshot_load(t4_stset_snapshot_t * self, const char * path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return T4_STSET_SNAPSHOT_IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return T4_STSET_SNAPSHOT_IO_ERROR;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    if (size < sizeof(t4_stset_snapshot_header_t)) {
+        close(fd);
+        return T4_STSET_SNAPSHOT_BAD_FORMAT;
+    }
+
+    /* Shared and never written, so every process mapping the file reads the same pages of the page cache. */
+    u8 * map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return T4_STSET_SNAPSHOT_IO_ERROR;
+    }
+
+    const t4_stset_snapshot_header_t * h = (const t4_stset_snapshot_header_t *)map;
+
+    const enum t4_stset_snapshot_status status = t4_stset_snapshot_check(h, size);
+    if (status != T4_STSET_SNAPSHOT_OK) {
+        munmap(map, size);
+        return status;
+    }
+
+    t4_internal_stset_seed = h->seed;
+    t4_stset_snapshot_seed = h->seed;
+    t4_stset_snapshot_seeded = true;
+
+    self->map = map;
+    self->map_size = size;
+    self->set = (t4_stset_t) {
+        .capacity = h->capacity,
+        .metadata = map + h->metadata_offset,
+        .index = (u32 *)(map + h->index_offset),
+        .entries = (t4_stset_entry_t *)(map + h->entries_offset),
+        .num_entries = h->num_entries,
+        .entries_capacity = h->num_entries,
+        .size = h->num_entries,
+        .tombstones = 0,
+        /* Any insert of a new key would then have to make room first, writing to the map. */
+        .growth_left = 0,
+        .max_load_factor = T4_STSET_DEFAULT_MAX_LOAD_FACTOR,
+        .fold_case = (h->flags & T4_STSET_SNAPSHOT_FOLD_CASE) != 0,
+        .owns_keys = false,
+        .arena = t4_arena_new(),
+        .key_base = map + h->keys_offset,
+        .value_size = 0,
+        .values = NULL,
+    };
+
+    return T4_STSET_SNAPSHOT_OK;
+}
+
+void t4_stset_snapshot_free(t4_stset_snapshot_t * self) {
+    munmap(self->map, self->map_size);
+
+    self->map = NULL;
+    self->map_size = 0;
+    self->set = (t4_stset_t) { 0 };
+}
@@ -0,0 +1,36 @@
+#include "t4/stset.h"
+
+#include "t4/internal/stset_group_sse2.h"
+
+#define T4_STSET_BACKEND sse2
+#include "t4/internal/stset_impl.h"
+
+const struct t4_internal_stset_vtable t4_internal_stset_vtable_sse2 = {
+    .get_alignment = t4_stset_get_alignment_sse2,
+
+    .new = t4_stset_new_sse2,
+    .free = t4_stset_free_sse2,
+
+    .insert_unchecked = t4_stset_insert_unchecked_sse2,
+    .try_insert = t4_stset_try_insert_sse2,
+
+    .exists = t4_stset_exists_sse2,
+
+    .remove = t4_stset_remove_sse2,
+
+    .insert_unchecked_with_hash = t4_stset_insert_unchecked_with_hash_sse2,
+    .try_insert_with_hash = t4_stset_try_insert_with_hash_sse2,
+    .exists_with_hash = t4_stset_exists_with_hash_sse2,
+    .remove_with_hash = t4_stset_remove_with_hash_sse2,
+
+    .try_insert_exists = t4_stset_try_insert_exists_sse2,
+
+    .try_insert_batch = t4_stset_try_insert_batch_sse2,
+    .exists_batch = t4_stset_exists_batch_sse2,
+    .try_insert_exists_batch = t4_stset_try_insert_exists_batch_sse2,
+
+    .probe_length = t4_stset_probe_length_sse2,
+
+    .map_upsert = t4_stset_map_upsert_sse2,
+    .map_get = t4_stset_map_get_sse2,
+};
@@ -0,0 +1,200 @@
+#include "t4/tokenize.h"
+
+#include "t4/rtinfo.h"
+#include "t4/internal/utf8_tables.h"
+
+t4_tokenizer_t t4_tokenizer_new(char * buf, const size_t size) {
+    t4_tokenizer_t res = {
+        .buf = buf,
+        .size = size,
+        .pos = 0,
+        .start = T4_TOKENIZE_NO_WORD,
+        .readonly = false,
+        .non_ascii = 0,
+        .next = t4_internal_tokenize_scalar,
+    };
+
+#if defined(__AVX2__) && defined(__BMI__)
+    res.next = t4_internal_tokenize_avx2;
+#else
+    const t4_cpu_features_t features = t4_get_cpu_features();
+    if (features.avx2 && features.bmi1) {
+        res.next = t4_internal_tokenize_avx2;
+    }
+#endif
+
+    return res;
+}
+
+t4_tokenizer_t t4_tokenizer_new_readonly(const char * buf, const size_t size) {
+    t4_tokenizer_t res = t4_tokenizer_new((char *)buf, size);
+    res.readonly = true;
+    return res;
+}
+
+/* Whether a code point of at least 0x80 is part of a word */
+static bool t4_utf8_is_word(const u32 cp) {
+    size_t lo = 0;
+    size_t hi = sizeof(t4_utf8_word_ranges) / sizeof(t4_utf8_word_ranges[0]);
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (cp < t4_utf8_word_ranges[mid].first) {
+            hi = mid;
+        } else if (cp > t4_utf8_word_ranges[mid].last) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* The simple case folding of a code point of at least 0x80, itself if it has none */
+static u32 t4_utf8_fold(const u32 cp) {
+    size_t lo = 0;
+    size_t hi = sizeof(t4_utf8_folds) / sizeof(t4_utf8_folds[0]);
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const t4_utf8_fold_t * f = t4_utf8_folds + mid;
+
+        if (cp < f->first) {
+            hi = mid;
+        } else if (cp > f->last) {
+            lo = mid + 1;
+        } else {
+            return (cp - f->first) % f->stride == 0 ? (u32)(cp + f->delta) : cp;
+        }
+    }
+
+    return cp;
+}
+
+/**
+ * @param avail Bytes readable at s, at least 1
+ * @return The length of the character at s, or 0 if it is not valid UTF-8 (overlong, a surrogate, truncated, ...)
+ */
+static size_t t4_utf8_decode(const u8 * s, const size_t avail, u32 * cp) {
+    static const u32 min[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+    const size_t len = s[0] < 0xc2 ? 0 : s[0] < 0xe0 ? 2 : s[0] < 0xf0 ? 3 : s[0] < 0xf5 ? 4 : 0;
+    if (len == 0 || len > avail) {
+        return 0;
+    }
+
+    u32 res = s[0] & (0x7f >> len);
+    for (size_t i = 1; i < len; i++) {
+        if ((s[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+        res = (res << 6) | (s[i] & 0x3f);
+    }
+
+    if (res < min[len] || res > 0x10ffff || (res >= 0xd800 && res < 0xe000)) {
+        return 0;
+    }
+
+    *cp = res;
+    return len;
+}
+
+/* Only ever called with a code point of the same encoded length as the one it replaces. */
+static void t4_utf8_encode(u8 * s, u32 cp, const size_t len) {
+    static const u8 lead[5] = { 0, 0, 0xc0, 0xe0, 0xf0 };
+
+    for (size_t i = len; i-- > 1;) {
+        s[i] = 0x80 | (cp & 0x3f);
+        cp >>= 6;
+    }
+    s[0] = lead[len] | cp;
+}
+
+size_t t4_internal_tokenize_utf8(t4_tokenizer_t * self, t4_token_t * tokens, const size_t max_tokens, const size_t end) {
+    u8 * buf = (u8 *)self->buf;
+    const size_t size = self->size;
+
+    size_t pos = self->pos;
+    size_t start = self->start;
+    size_t non_ascii = self->non_ascii;
+    size_t n = 0;
+
+    while (pos < end && n < max_tokens) {
+        size_t len = 1;
+        bool word;
+
+        if (buf[pos] < 0x80) {
+            word = t4_is_ascii_letter(buf[pos]);
+            if (word && !self->readonly) {
+                buf[pos] |= 0x20;
+            }
+        } else {
+            u32 cp = 0;
+            u32 folded = 0;
+            len = t4_utf8_decode(buf + pos, size - pos, &cp);
+
+            /* Two bytes cover Latin, Greek, Cyrillic, Hebrew and Arabic, so those skip the searches. */
+            if (len == 2) {
+                const u16 info = t4_utf8_two_byte[cp - 0x80];
+                word = info >> 15;
+                folded = info & 0x7fff;
+            } else {
+                word = len != 0 && t4_utf8_is_word(cp);
+                folded = word ? t4_utf8_fold(cp) : cp;
+            }
+
+            non_ascii += word;
+
+            if (folded != cp && !self->readonly) {
+                t4_utf8_encode(buf + pos, folded, len);
+            }
+
+            /* An invalid byte separates words like any other, and the next one is tried on its own. */
+            len = len != 0 ? len : 1;
+        }
+
+        if (word) {
+            start = start == T4_TOKENIZE_NO_WORD ? pos : start;
+        } else if (start != T4_TOKENIZE_NO_WORD) {
+            tokens[n++] = (t4_token_t) { .offset = start, .size = pos - start, };
+            start = T4_TOKENIZE_NO_WORD;
+        }
+
+        pos += len;
+    }
+
+    self->pos = pos;
+    self->start = start;
+    self->non_ascii = non_ascii;
+
+    return n;
+}
+
+size_t t4_internal_tokenize_scalar(t4_tokenizer_t * self, t4_token_t * tokens, const size_t max_tokens) {
+    size_t n = t4_internal_tokenize_utf8(self, tokens, max_tokens, self->size);
+
+    if (self->pos == self->size && self->start != T4_TOKENIZE_NO_WORD && n < max_tokens) {
+        tokens[n++] = (t4_token_t) { .offset = self->start, .size = self->size - self->start, };
+        self->start = T4_TOKENIZE_NO_WORD;
+    }
+
+    return n;
+}
+
+void t4_tokenize_fold(char * word, const size_t size) {
+    t4_tokenizer_t self = {
+        .buf = word,
+        .size = size,
+        .pos = 0,
+        .start = T4_TOKENIZE_NO_WORD,
+        .readonly = false,
+        .non_ascii = 0,
+        .next = t4_internal_tokenize_scalar,
+    };
+
+    /* A single word has no separator in it, so no token is ever written and one is enough room. */
+    t4_token_t token;
+    t4_internal_tokenize_utf8(&self, &token, 1, size);
+}
@@ -0,0 +1,73 @@
+#include "t4/tokenize.h"
+
+#include <immintrin.h>
+
+size_t t4_internal_tokenize_avx2(t4_tokenizer_t * self, t4_token_t * tokens, const size_t max_tokens) {
+    char * buf = self->buf;
+    const size_t size = self->size;
+
+    size_t pos = self->pos;
+    size_t start = self->start;
+    size_t n = 0;
+
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    /* Moves 'a'..'z' to the 26 lowest signed bytes, so a single signed compare finds them. */
+    const __m256i bias = _mm256_set1_epi8((char)(0x80 - 'a'));
+    const __m256i limit = _mm256_set1_epi8((char)(0x80 + 26));
+
+    /* A block ends at most T4_TOKENIZE_BLOCK_TOKENS words, so a whole one always fits. */
+    while (pos + 32 <= size && max_tokens - n >= T4_TOKENIZE_BLOCK_TOKENS) {
+        const __m256i bytes = _mm256_loadu_si256((const __m256i *)(buf + pos));
+        const __m256i lower = _mm256_or_si256(bytes, case_bit);
+        const __m256i letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(lower, bias));
+
+        if (!self->readonly) {
+            _mm256_storeu_si256((__m256i *)(buf + pos), _mm256_or_si256(bytes, _mm256_and_si256(letters, case_bit)));
+        }
+
+        /* Only the bytes before the first non-ASCII one are done here, 32 when there is none. */
+        const u32 non_ascii = (u32)_mm256_movemask_epi8(bytes);
+        const u32 ascii = _tzcnt_u32(non_ascii);
+        const u32 valid = ascii == 32 ? UINT32_MAX : (1u << ascii) - 1;
+
+        /* Every set bit is where a word starts or ends, alternating, with the previous byte carried in. */
+        const u32 mask = (u32)_mm256_movemask_epi8(letters);
+        u32 edges = (mask ^ ((mask << 1) | (start != T4_TOKENIZE_NO_WORD))) & valid;
+
+        while (edges != 0) {
+            const size_t i = pos + _tzcnt_u32(edges);
+
+            if (start == T4_TOKENIZE_NO_WORD) {
+                start = i;
+            } else {
+                tokens[n++] = (t4_token_t) { .offset = start, .size = i - start, };
+                start = T4_TOKENIZE_NO_WORD;
+            }
+
+            edges = _blsr_u32(edges);
+        }
+
+        pos += ascii;
+
+        if (ascii != 32) {
+            /* Decodes only the run of non-ASCII bytes, what follows it may well be ASCII again. */
+            const u32 run = _tzcnt_u32(~(non_ascii >> ascii));
+
+            self->pos = pos;
+            self->start = start;
+            n += t4_internal_tokenize_utf8(self, tokens + n, max_tokens - n, pos + run);
+            pos = self->pos;
+            start = self->start;
+        }
+    }
+
+    self->pos = pos;
+    self->start = start;
+
+    if (n == max_tokens) {
+        return n;
+    }
+
+    /* The last partial block, or a batch too small for another whole one. */
+    return n + t4_internal_tokenize_scalar(self, tokens + n, max_tokens - n);
+}
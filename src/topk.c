@@ -0,0 +1,90 @@
+#include "t4/topk.h"
+
+#include "t4/mem.h"
+
+#include <stdlib.h>
+
+/* Whether a ranks below b: a lower score, or the same score and a higher id. */
+static inline bool t4_topk_below(const t4_topk_item_t a, const t4_topk_item_t b) {
+    return a.score != b.score ? a.score < b.score : a.id > b.id;
+}
+
+static void t4_topk_sift_down(t4_topk_item_t * items, const size_t len, size_t i) {
+    for (;;) {
+        const size_t l = 2 * i + 1;
+        const size_t r = l + 1;
+        size_t min = i;
+
+        if (l < len && t4_topk_below(items[l], items[min])) {
+            min = l;
+        }
+        if (r < len && t4_topk_below(items[r], items[min])) {
+            min = r;
+        }
+        if (min == i) {
+            return;
+        }
+
+        const t4_topk_item_t tmp = items[i];
+        items[i] = items[min];
+        items[min] = tmp;
+        i = min;
+    }
+}
+
+static void t4_topk_sift_up(t4_topk_item_t * items, size_t i) {
+    while (i > 0) {
+        const size_t parent = (i - 1) / 2;
+        if (!t4_topk_below(items[i], items[parent])) {
+            return;
+        }
+
+        const t4_topk_item_t tmp = items[i];
+        items[i] = items[parent];
+        items[parent] = tmp;
+        i = parent;
+    }
+}
+
+t4_topk_t t4_topk_new(const size_t k) {
+    return (t4_topk_t) {
+        .items = t4_calloc(k == 0 ? 1 : k, sizeof(t4_topk_item_t)),
+        .len = 0,
+        .k = k,
+    };
+}
+
+void t4_topk_free(t4_topk_t * self) {
+    t4_free(self->items);
+    self->len = 0;
+    self->k = 0;
+}
+
+void t4_topk_push(t4_topk_t * self, const u64 score, const size_t id) {
+    const t4_topk_item_t item = { .score = score, .id = id, };
+
+    if (self->len < self->k) {
+        self->items[self->len] = item;
+        t4_topk_sift_up(self->items, self->len++);
+        return;
+    }
+
+    /* Full, the root is the lowest kept item; most items in a long tail do not even beat that. */
+    if (self->k != 0 && t4_topk_below(self->items[0], item)) {
+        self->items[0] = item;
+        t4_topk_sift_down(self->items, self->len, 0);
+    }
+}
+
+static int t4_topk_cmp_desc(const void * a, const void * b) {
+    const t4_topk_item_t x = *(const t4_topk_item_t *)a;
+    const t4_topk_item_t y = *(const t4_topk_item_t *)b;
+
+    return t4_topk_below(y, x) ? -1 : t4_topk_below(x, y) ? 1 : 0;
+}
+
+size_t t4_topk_sort(t4_topk_t * self) {
+    /* Only k items, so a plain sort is fine here. */
+    qsort(self->items, self->len, sizeof(t4_topk_item_t), t4_topk_cmp_desc);
+    return self->len;
+}